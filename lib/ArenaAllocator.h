@@ -0,0 +1,333 @@
+/**
+ * @file ArenaAllocator.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A monotonic arena for short-lived allocations, such as the vectors
+ * built while serving one request. An Arena hands out storage by bumping a
+ * pointer through large blocks and never frees individual allocations. Instead
+ * reset releases everything at once, and the arena's destructor does the same.
+ *
+ * The one exception is the most recent allocation, which deallocate gives back
+ * to the bump pointer, so a scratch buffer freed straight away costs nothing.
+ * Likewise reallocate resizes the most recent allocation in place while its
+ * block has room, so a vector of trivially copyable elements that is the only
+ * one growing leaves no abandoned buffers behind.
+ *
+ * ArenaAllocator<T> meets the standard Allocator requirements. It refers to an
+ * Arena that the caller owns and that must outlive every container using it.
+ * Copies and rebinds share the Arena. Neither class is thread-safe.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+class Arena {
+ private:
+  /* Inner Classes */
+  class Block {
+   public:
+    Block *_next;
+  };
+
+  /* Static Members */
+  static const size_t _default_block_size = 64 * 1024;
+
+  /* Members */
+  size_t _block_size;
+  Block *_blocks;
+  char *_cursor;
+  char *_end;
+  char *_last;
+  size_t _bytes_allocated;
+
+  /* Helpers */
+  void grow(size_t, size_t);
+
+ public:
+  /* Constructors */
+  explicit Arena(size_t = _default_block_size);
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+  ~Arena();
+
+  /* Util */
+  size_t bytes_allocated() const;
+
+  /* Mutators */
+  void *allocate(size_t, size_t);
+  void deallocate(void *, size_t);
+  void *reallocate(void *, size_t, size_t, size_t);
+  void reset();
+};
+
+template <typename T>
+class ArenaAllocator {
+ public:
+  /* Typedefs */
+  typedef T value_type;
+  typedef std::false_type is_always_equal;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  /* Constructors */
+  explicit ArenaAllocator(Arena &);
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &);
+
+  /* Accessors */
+  Arena &arena() const;
+
+  /* Mutators */
+  T *allocate(size_t);
+  void deallocate(T *, size_t);
+  T *reallocate(T *, size_t, size_t);
+
+  /* Operators */
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &) const;
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &) const;
+
+ private:
+  Arena *_arena;
+
+  template <typename U>
+  friend class ArenaAllocator;
+};
+
+/**
+ * @brief Starts a new block big enough for bytes at the given alignment. An
+ * allocation larger than the block size gets a block of its own
+ *
+ * @param bytes
+ * @param alignment
+ */
+inline void Arena::grow(size_t bytes, size_t alignment) {
+  size_t needed = sizeof(Block) + alignment - 1 + bytes;
+  size_t size = needed > _block_size ? needed : _block_size;
+
+  Block *block = static_cast<Block *>(::operator new(size));
+  block->_next = _blocks;
+  _blocks = block;
+  _cursor = reinterpret_cast<char *>(block) + sizeof(Block);
+  _end = reinterpret_cast<char *>(block) + size;
+}
+
+/**
+ * @brief Construct an empty Arena. The first block is allocated lazily
+ *
+ * @param block_size bytes per block, including a pointer-sized header
+ */
+inline Arena::Arena(size_t block_size)
+    : _block_size(block_size),
+      _blocks(nullptr),
+      _cursor(nullptr),
+      _end(nullptr),
+      _last(nullptr),
+      _bytes_allocated(0) {}
+
+/**
+ * @brief Destroy the Arena, releasing every block. Objects still living in the
+ * arena are not destroyed
+ */
+inline Arena::~Arena() { reset(); }
+
+/**
+ * @brief Returns the bytes handed out since the last reset, less any returned
+ * by deallocate
+ *
+ * @return size_t
+ */
+inline size_t Arena::bytes_allocated() const { return _bytes_allocated; }
+
+/**
+ * @brief Allocate bytes of storage aligned to alignment, which must be a power
+ * of two
+ *
+ * @param bytes
+ * @param alignment
+ * @return void*
+ */
+inline void *Arena::allocate(size_t bytes, size_t alignment) {
+  uintptr_t cursor = reinterpret_cast<uintptr_t>(_cursor);
+  uintptr_t start = (cursor + alignment - 1) & ~uintptr_t(alignment - 1);
+
+  if (!_cursor || start + bytes > reinterpret_cast<uintptr_t>(_end)) {
+    grow(bytes, alignment);
+    cursor = reinterpret_cast<uintptr_t>(_cursor);
+    start = (cursor + alignment - 1) & ~uintptr_t(alignment - 1);
+  }
+
+  _last = reinterpret_cast<char *>(start);
+  _cursor = _last + bytes;
+  _bytes_allocated += bytes;
+  return _last;
+}
+
+/**
+ * @brief Give back the storage of the most recent allocation. Anything else is
+ * only released by reset
+ *
+ * @param p
+ * @param bytes must match the size passed to allocate
+ */
+inline void Arena::deallocate(void *p, size_t bytes) {
+  if (p != _last || !p) return;
+
+  _cursor = _last;
+  _last = nullptr;
+  _bytes_allocated -= bytes;
+}
+
+/**
+ * @brief Resize an allocation and return its new address. The most recent
+ * allocation is resized in place if its block has room. Otherwise new storage
+ * is allocated and the first min(old_bytes, new_bytes) bytes copied over
+ *
+ * @param p storage from allocate or reallocate, or nullptr
+ * @param old_bytes must match the size p was last allocated with
+ * @param new_bytes
+ * @param alignment must match the alignment p was allocated with
+ * @return void*
+ */
+inline void *Arena::reallocate(void *p, size_t old_bytes, size_t new_bytes,
+                               size_t alignment) {
+  if (p && p == _last && new_bytes <= size_t(_end - _last)) {
+    _cursor = _last + new_bytes;
+    _bytes_allocated += new_bytes;
+    _bytes_allocated -= old_bytes;
+    return p;
+  }
+
+  void *q = allocate(new_bytes, alignment);
+  if (p) memcpy(q, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+  return q;
+}
+
+/**
+ * @brief Release every block at once. Objects still living in the arena are
+ * not destroyed, and their storage must not be touched again
+ */
+inline void Arena::reset() {
+  while (_blocks) {
+    Block *next_block = _blocks->_next;
+    ::operator delete(_blocks);
+    _blocks = next_block;
+  }
+
+  _cursor = _end = _last = nullptr;
+  _bytes_allocated = 0;
+}
+
+/**
+ * @brief Construct an allocator that draws from arena
+ *
+ * @tparam T
+ * @param arena
+ */
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(Arena &arena) : _arena(&arena) {}
+
+/**
+ * @brief Rebind Constructor: share other's arena
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ */
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U> &other)
+    : _arena(other._arena) {}
+
+/**
+ * @brief Returns the arena this allocator draws from
+ *
+ * @tparam T
+ * @return Arena&
+ */
+template <typename T>
+Arena &ArenaAllocator<T>::arena() const {
+  return *_arena;
+}
+
+/**
+ * @brief Allocate storage for n objects of type T from the arena
+ *
+ * @tparam T
+ * @param n
+ * @return T*
+ */
+template <typename T>
+T *ArenaAllocator<T>::allocate(size_t n) {
+  return static_cast<T *>(_arena->allocate(n * sizeof(T), alignof(T)));
+}
+
+/**
+ * @brief Return storage to the arena. Only the most recent allocation is
+ * actually reused
+ *
+ * @tparam T
+ * @param p
+ * @param n must match the count passed to allocate
+ */
+template <typename T>
+void ArenaAllocator<T>::deallocate(T *p, size_t n) {
+  _arena->deallocate(p, n * sizeof(T));
+}
+
+/**
+ * @brief Resize storage for old_n objects to hold new_n, in place if it is the
+ * arena's most recent allocation and still fits. The contents are moved as raw
+ * bytes, so T must be trivially copyable
+ *
+ * @tparam T
+ * @param p
+ * @param old_n must match the count the storage was last allocated for
+ * @param new_n
+ * @return T*
+ */
+template <typename T>
+T *ArenaAllocator<T>::reallocate(T *p, size_t old_n, size_t new_n) {
+  return static_cast<T *>(_arena->reallocate(p, old_n * sizeof(T),
+                                             new_n * sizeof(T), alignof(T)));
+}
+
+/**
+ * @brief Two allocators are equal if they share an arena, meaning either can
+ * free what the other allocated
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool ArenaAllocator<T>::operator==(const ArenaAllocator<U> &other) const {
+  return _arena == other._arena;
+}
+
+/**
+ * @brief Returns true if the allocators do not share an arena
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool ArenaAllocator<T>::operator!=(const ArenaAllocator<U> &other) const {
+  return _arena != other._arena;
+}
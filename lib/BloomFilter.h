@@ -0,0 +1,165 @@
+/**
+ * @file BloomFilter.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A blocked Bloom filter over 64-bit hashes, used by HashMap to answer
+ * most lookups of absent keys without touching the table.
+ *
+ * The filter is an array of 512-bit blocks, each aligned to a cache line. The
+ * high half of a hash picks one block, and the low half sets one bit in each
+ * of the block's eight words. A query therefore reads a single cache line,
+ * and its eight word tests have no branches between them, so the compiler can
+ * turn them into vector instructions. At 10 bits per key about 1% of absent
+ * keys pass the filter.
+ *
+ * Like any Bloom filter it cannot forget a key, so it gives false positives,
+ * never false negatives. The hashes must already be well mixed, such as the
+ * output of mix_hash.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BlockedBloomFilter {
+ private:
+  /* Inner Classes */
+  class alignas(64) Block {
+   public:
+    uint64_t _words[8];
+  };
+
+  /* Static Members */
+  static const size_t _block_bits = 512;
+
+  /* Members */
+  std::vector<Block> _blocks;
+
+  /* Helpers */
+  static uint64_t bit(uint64_t, size_t);
+  Block &block(uint64_t);
+  const Block &block(uint64_t) const;
+
+ public:
+  /* Util */
+  bool is_empty() const;
+  size_t bytes() const;
+
+  /* Accessors */
+  bool may_contain(uint64_t) const;
+
+  /* Mutators */
+  void reset(size_t, size_t);
+  void clear();
+  void insert(uint64_t);
+};
+
+/**
+ * @brief Returns the bit that hash sets in word i of its block. Each word
+ * multiplies the low half of hash by a different odd constant and keeps the
+ * top 6 bits of the product
+ *
+ * @param hash
+ * @param i
+ * @return uint64_t
+ */
+inline uint64_t BlockedBloomFilter::bit(uint64_t hash, size_t i) {
+  static const uint32_t salts[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                    0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                    0x9efc4947U, 0x5c6bfb31U};
+  return uint64_t(1) << ((uint32_t(hash) * salts[i]) >> 26);
+}
+
+/**
+ * @brief Returns the block that hash maps to. The high half of hash is scaled
+ * to the block count with a multiply and shift, so the count need not be a
+ * power of two
+ *
+ * @param hash
+ * @return Block&
+ */
+inline BlockedBloomFilter::Block &BlockedBloomFilter::block(uint64_t hash) {
+  return _blocks[((hash >> 32) * _blocks.size()) >> 32];
+}
+
+/**
+ * @brief Returns the block that hash maps to
+ *
+ * @param hash
+ * @return const Block&
+ */
+inline const BlockedBloomFilter::Block &BlockedBloomFilter::block(
+    uint64_t hash) const {
+  return _blocks[((hash >> 32) * _blocks.size()) >> 32];
+}
+
+/**
+ * @brief Returns true if the filter has no blocks. An empty filter rejects
+ * nothing
+ *
+ * @return boolean
+ */
+inline bool BlockedBloomFilter::is_empty() const { return _blocks.empty(); }
+
+/**
+ * @brief Returns the size of the bit array in bytes
+ *
+ * @return size_t
+ */
+inline size_t BlockedBloomFilter::bytes() const {
+  return _blocks.size() * sizeof(Block);
+}
+
+/**
+ * @brief Returns false if hash was certainly never inserted since the last
+ * reset. An empty filter returns true for every hash
+ *
+ * @param hash
+ * @return boolean
+ */
+inline bool BlockedBloomFilter::may_contain(uint64_t hash) const {
+  if (_blocks.empty()) return true;
+
+  const Block &b = block(hash);
+  uint64_t missing = 0;
+  for (size_t i = 0; i < 8; i++) missing |= bit(hash, i) & ~b._words[i];
+  return !missing;
+}
+
+/**
+ * @brief Drop every hash and resize the filter for keys hashes at
+ * bits_per_key bits each, rounded up to whole blocks. A filter sized for no
+ * keys is empty
+ *
+ * @param keys
+ * @param bits_per_key
+ */
+inline void BlockedBloomFilter::reset(size_t keys, size_t bits_per_key) {
+  size_t blocks = (keys * bits_per_key + _block_bits - 1) / _block_bits;
+  _blocks.assign(blocks, Block());
+}
+
+/**
+ * @brief Release the bit array, leaving an empty filter
+ */
+inline void BlockedBloomFilter::clear() {
+  std::vector<Block>().swap(_blocks);
+}
+
+/**
+ * @brief Add hash to the filter. Does nothing to an empty filter
+ *
+ * @param hash
+ */
+inline void BlockedBloomFilter::insert(uint64_t hash) {
+  if (_blocks.empty()) return;
+
+  Block &b = block(hash);
+  for (size_t i = 0; i < 8; i++) b._words[i] |= bit(hash, i);
+}
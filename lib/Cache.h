@@ -0,0 +1,742 @@
+/**
+ * @file Cache.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief Bounded key/value caches built on HashMap. Both evict entries once
+ * their total weight passes a capacity. By default every entry weighs 1, so
+ * the capacity is an entry count. A Weigher that returns a byte size makes it
+ * a byte budget. Each cache counts hits, misses and evictions.
+ *
+ * LRUCache keeps its entries in a LinkedList ordered by recency, and the
+ * HashMap maps each key to its list node. A hit moves the node to the front,
+ * and eviction removes the back, all in O(1).
+ *
+ * ClockCache approximates LRU with the CLOCK algorithm. Entries sit in a flat
+ * array, and a hit only sets a referenced flag (and only if it is clear), so
+ * hits on hot keys write nothing. To evict, a hand sweeps the array, clearing
+ * flags as it passes, and removes the first entry whose flag was already
+ * clear.
+ *
+ * Neither cache is thread-safe.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "HashMapV1.h"
+#include "LinkedList.h"
+
+/**
+ * @brief The default cache Weigher. Every entry weighs 1, so a capacity is a
+ * number of entries
+ */
+class UnitWeigher {
+ public:
+  template <typename K, typename V>
+  size_t operator()(const K &, const V &) const {
+    return 1;
+  }
+};
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K>, typename Weigher = UnitWeigher>
+class LRUCache {
+ private:
+  /* Inner Classes */
+  class Entry {
+   public:
+    K _key;
+    V _val;
+    size_t _charge;
+
+    Entry(const K &, const V &, size_t);
+  };
+
+  /* Members */
+  size_t _capacity;
+  size_t _weight;
+  LinkedList<Entry> _order;
+  HashMap<K, ListNode<Entry> *, Hash, Pred> _index;
+  uint64_t _hits;
+  uint64_t _misses;
+  uint64_t _evictions;
+
+  /* Helpers */
+  void evict(size_t);
+
+ public:
+  /* Constructors */
+  explicit LRUCache(size_t);
+  LRUCache(const LRUCache &) = delete;
+  LRUCache &operator=(const LRUCache &) = delete;
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t weight();
+  size_t capacity();
+  bool has(const K &);
+  uint64_t hits();
+  uint64_t misses();
+  uint64_t evictions();
+
+  /* Accessors */
+  V *find(const K &);
+
+  /* Mutators */
+  void put(const K &, const V &);
+  void erase(const K &);
+};
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K>, typename Weigher = UnitWeigher>
+class ClockCache {
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    std::optional<std::pair<K, V>> _entry;
+    size_t _charge;
+    bool _referenced;
+
+    Slot();
+  };
+
+  /* Members */
+  size_t _capacity;
+  size_t _weight;
+  std::vector<Slot> _slots;
+  std::vector<size_t> _free;
+  size_t _hand;
+  HashMap<K, size_t, Hash, Pred> _index;
+  uint64_t _hits;
+  uint64_t _misses;
+  uint64_t _evictions;
+
+  /* Helpers */
+  void remove(size_t);
+  void evict(size_t, size_t);
+
+ public:
+  /* Constructors */
+  explicit ClockCache(size_t);
+  ClockCache(const ClockCache &) = delete;
+  ClockCache &operator=(const ClockCache &) = delete;
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t weight();
+  size_t capacity();
+  bool has(const K &);
+  uint64_t hits();
+  uint64_t misses();
+  uint64_t evictions();
+
+  /* Accessors */
+  V *find(const K &);
+
+  /* Mutators */
+  void put(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Construct a new Entry
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @param value
+ * @param charge the entry's weight
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+LRUCache<K, V, Hash, Pred, Weigher>::Entry::Entry(const K &key, const V &value,
+                                                  size_t charge)
+    : _key(key), _val(value), _charge(charge) {}
+
+/**
+ * @brief Evicts least recently used entries until the total weight is at most
+ * limit
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param limit
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void LRUCache<K, V, Hash, Pred, Weigher>::evict(size_t limit) {
+  while (_weight > limit) {
+    ListNode<Entry> *node = _order.back_node();
+    _weight -= node->value()._charge;
+    _index.erase(node->value()._key);
+    _order.erase_node(node);
+    _evictions++;
+  }
+}
+
+/**
+ * @brief Construct an empty LRUCache
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param capacity the most total weight the cache holds
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+LRUCache<K, V, Hash, Pred, Weigher>::LRUCache(size_t capacity)
+    : _capacity(capacity), _weight(0), _hits(0), _misses(0), _evictions(0) {}
+
+/**
+ * @brief Returns true if the cache is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+bool LRUCache<K, V, Hash, Pred, Weigher>::is_empty() {
+  return _order.is_empty();
+}
+
+/**
+ * @brief Returns the number of cached entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t LRUCache<K, V, Hash, Pred, Weigher>::size() {
+  return _order.size();
+}
+
+/**
+ * @brief Returns the total weight of the cached entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t LRUCache<K, V, Hash, Pred, Weigher>::weight() {
+  return _weight;
+}
+
+/**
+ * @brief Returns the most total weight the cache holds
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t LRUCache<K, V, Hash, Pred, Weigher>::capacity() {
+  return _capacity;
+}
+
+/**
+ * @brief Returns true if key is cached. Unlike find, this is not counted as a
+ * hit or miss and does not refresh the entry
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+bool LRUCache<K, V, Hash, Pred, Weigher>::has(const K &key) {
+  return _index.has(key);
+}
+
+/**
+ * @brief Returns the number of finds that found their key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t LRUCache<K, V, Hash, Pred, Weigher>::hits() {
+  return _hits;
+}
+
+/**
+ * @brief Returns the number of finds that did not find their key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t LRUCache<K, V, Hash, Pred, Weigher>::misses() {
+  return _misses;
+}
+
+/**
+ * @brief Returns the number of entries removed to make room for others
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t LRUCache<K, V, Hash, Pred, Weigher>::evictions() {
+  return _evictions;
+}
+
+/**
+ * @brief Returns a pointer to the value cached for key, marking it most
+ * recently used, or nullptr on a miss. The pointer is valid until the entry is
+ * evicted or erased
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+V *LRUCache<K, V, Hash, Pred, Weigher>::find(const K &key) {
+  ListNode<Entry> **node = _index.find(key);
+  if (!node) {
+    _misses++;
+    return nullptr;
+  }
+
+  _hits++;
+  _order.move_to_front(*node);
+  return &(*node)->value()._val;
+}
+
+/**
+ * @brief Cache value under key as the most recently used entry, replacing any
+ * value already cached for key, then evict until the cache is within capacity.
+ * An entry heavier than the whole capacity is not cached at all
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void LRUCache<K, V, Hash, Pred, Weigher>::put(const K &key, const V &value) {
+  size_t charge = Weigher()(key, value);
+  if (charge > _capacity) {
+    erase(key);
+    return;
+  }
+
+  ListNode<Entry> **found = _index.find(key);
+  if (found) {
+    Entry &entry = (*found)->value();
+    _weight = _weight - entry._charge + charge;
+    entry._val = value;
+    entry._charge = charge;
+    _order.move_to_front(*found);
+    evict(_capacity);
+    return;
+  }
+
+  evict(_capacity - charge);
+  _index.insert(key, _order.push_front_node(Entry(key, value, charge)));
+  _weight += charge;
+}
+
+/**
+ * @brief Remove key's entry, if it is cached
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void LRUCache<K, V, Hash, Pred, Weigher>::erase(const K &key) {
+  ListNode<Entry> **found = _index.find(key);
+  if (!found) return;
+
+  ListNode<Entry> *node = *found;
+  _weight -= node->value()._charge;
+  _index.erase(key);
+  _order.erase_node(node);
+}
+
+/**
+ * @brief Construct an empty Slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+ClockCache<K, V, Hash, Pred, Weigher>::Slot::Slot()
+    : _charge(0), _referenced(false) {}
+
+/**
+ * @brief Empties slot i and puts it on the free list. The key and value are
+ * destroyed here, not when the slot is reused, so whatever they own is freed
+ * as soon as the entry leaves the cache
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param i
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void ClockCache<K, V, Hash, Pred, Weigher>::remove(size_t i) {
+  Slot &slot = _slots[i];
+  _weight -= slot._charge;
+  _index.erase(slot._entry->first);
+  slot._entry.reset();
+  _free.push_back(i);
+}
+
+/**
+ * @brief Advances the hand, evicting unreferenced entries, until the total
+ * weight is at most limit. A referenced entry that the hand passes loses its
+ * flag, so it is evicted on the next sweep unless it is hit again first. The
+ * entry in slot keep is never evicted
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param limit
+ * @param keep a slot index, or _slots.size() to allow any eviction
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void ClockCache<K, V, Hash, Pred, Weigher>::evict(size_t limit, size_t keep) {
+  while (_weight > limit) {
+    Slot &slot = _slots[_hand];
+    size_t i = _hand;
+    _hand = (_hand + 1) % _slots.size();
+
+    if (!slot._entry || i == keep) continue;
+    if (slot._referenced) {
+      slot._referenced = false;
+      continue;
+    }
+
+    remove(i);
+    _evictions++;
+  }
+}
+
+/**
+ * @brief Construct an empty ClockCache
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param capacity the most total weight the cache holds
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+ClockCache<K, V, Hash, Pred, Weigher>::ClockCache(size_t capacity)
+    : _capacity(capacity),
+      _weight(0),
+      _hand(0),
+      _hits(0),
+      _misses(0),
+      _evictions(0) {}
+
+/**
+ * @brief Returns true if the cache is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+bool ClockCache<K, V, Hash, Pred, Weigher>::is_empty() {
+  return _index.is_empty();
+}
+
+/**
+ * @brief Returns the number of cached entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t ClockCache<K, V, Hash, Pred, Weigher>::size() {
+  return _index.size();
+}
+
+/**
+ * @brief Returns the total weight of the cached entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t ClockCache<K, V, Hash, Pred, Weigher>::weight() {
+  return _weight;
+}
+
+/**
+ * @brief Returns the most total weight the cache holds
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+size_t ClockCache<K, V, Hash, Pred, Weigher>::capacity() {
+  return _capacity;
+}
+
+/**
+ * @brief Returns true if key is cached. Unlike find, this is not counted as a
+ * hit or miss and does not reference the entry
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+bool ClockCache<K, V, Hash, Pred, Weigher>::has(const K &key) {
+  return _index.has(key);
+}
+
+/**
+ * @brief Returns the number of finds that found their key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t ClockCache<K, V, Hash, Pred, Weigher>::hits() {
+  return _hits;
+}
+
+/**
+ * @brief Returns the number of finds that did not find their key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t ClockCache<K, V, Hash, Pred, Weigher>::misses() {
+  return _misses;
+}
+
+/**
+ * @brief Returns the number of entries removed to make room for others
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+uint64_t ClockCache<K, V, Hash, Pred, Weigher>::evictions() {
+  return _evictions;
+}
+
+/**
+ * @brief Returns a pointer to the value cached for key, marking it referenced,
+ * or nullptr on a miss. The pointer is valid until the next put or erase
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+V *ClockCache<K, V, Hash, Pred, Weigher>::find(const K &key) {
+  size_t *i = _index.find(key);
+  if (!i) {
+    _misses++;
+    return nullptr;
+  }
+
+  _hits++;
+  Slot &slot = _slots[*i];
+  if (!slot._referenced) slot._referenced = true;
+  return &slot._entry->second;
+}
+
+/**
+ * @brief Cache value under key, replacing any value already cached for key,
+ * then evict until the cache is within capacity. New entries start
+ * unreferenced, so a key that is never read again is the first to go. An entry
+ * heavier than the whole capacity is not cached at all
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void ClockCache<K, V, Hash, Pred, Weigher>::put(const K &key, const V &value) {
+  size_t charge = Weigher()(key, value);
+  if (charge > _capacity) {
+    erase(key);
+    return;
+  }
+
+  size_t *found = _index.find(key);
+  if (found) {
+    Slot &slot = _slots[*found];
+    _weight = _weight - slot._charge + charge;
+    slot._entry->second = value;
+    slot._charge = charge;
+    slot._referenced = true;
+    evict(_capacity, *found);
+    return;
+  }
+
+  evict(_capacity - charge, _slots.size());
+
+  size_t i;
+  if (_free.empty()) {
+    i = _slots.size();
+    _slots.emplace_back();
+  } else {
+    i = _free.back();
+    _free.pop_back();
+  }
+
+  Slot &slot = _slots[i];
+  slot._entry.emplace(key, value);
+  slot._charge = charge;
+  slot._referenced = false;
+
+  _index.insert(key, i);
+  _weight += charge;
+}
+
+/**
+ * @brief Remove key's entry, if it is cached
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Weigher
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Weigher>
+void ClockCache<K, V, Hash, Pred, Weigher>::erase(const K &key) {
+  size_t *i = _index.find(key);
+  if (i) remove(*i);
+}
@@ -0,0 +1,331 @@
+/**
+ * @file ConcurrentHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A thread-safe HashMap made of independently locked shards. Each key
+ * belongs to exactly one shard, which is an ordinary HashMap guarded by its own
+ * reader/writer lock. Lookups take the lock shared, so readers only contend
+ * with writers to the same shard, and each shard resizes on its own schedule.
+ *
+ * Values are returned by copy, since a reference into a shard would outlive the
+ * lock that protects it.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "HashMapV1.h"
+#include "Hashing.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K>,
+          typename Alloc = std::allocator<std::pair<const K, V> > >
+class ConcurrentHashMap {
+ private:
+  /* Inner Classes */
+  class alignas(64) Shard {
+   public:
+    std::shared_mutex _mutex;
+    HashMap<K, V, Hash, Pred, Alloc> _map;
+  };
+
+  /* Members */
+  size_t _shard_count;
+  unsigned _shard_shift;
+  Shard *_shards;
+  uint64_t _seed;
+
+  /* Helpers */
+  Shard &shard(const K &);
+
+ public:
+  /* Constructors */
+  explicit ConcurrentHashMap(size_t = 0);
+  ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+  ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+  ~ConcurrentHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t capacity();
+  double load_factor();
+  size_t shard_count();
+  bool has(const K &);
+
+  /* Accessors */
+  V get(const K &);
+  bool find(const K &, V &);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Returns the shard that owns key. Shards are picked by the top bits of
+ * a hash seeded separately from the shards' own tables, which bucket by the low
+ * bits
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ * @return Shard&
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+typename ConcurrentHashMap<K, V, Hash, Pred, Alloc>::Shard &
+ConcurrentHashMap<K, V, Hash, Pred, Alloc>::shard(const K &key) {
+  if (_shard_count == 1) return _shards[0];
+  return _shards[mix_hash(Hash()(key), _seed) >> _shard_shift];
+}
+
+/**
+ * @brief Construct a new ConcurrentHashMap. The shard count is rounded up to a
+ * power of two. If it is 0, four shards per hardware thread are used, which
+ * keeps the odds of two threads wanting the same shard low
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param shards
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+ConcurrentHashMap<K, V, Hash, Pred, Alloc>::ConcurrentHashMap(size_t shards)
+    : _shard_count(1), _shard_shift(64), _seed(random_seed()) {
+  if (!shards) shards = 4 * std::max(1U, std::thread::hardware_concurrency());
+
+  while (_shard_count < shards) {
+    _shard_count *= 2;
+    _shard_shift--;
+  }
+
+  _shards = new Shard[_shard_count];
+}
+
+/**
+ * @brief Destroy the ConcurrentHashMap object. No other thread may be using it
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+ConcurrentHashMap<K, V, Hash, Pred, Alloc>::~ConcurrentHashMap() {
+  delete[] _shards;
+}
+
+/**
+ * @brief Returns true if every shard is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+bool ConcurrentHashMap<K, V, Hash, Pred, Alloc>::is_empty() {
+  return !size();
+}
+
+/**
+ * @brief Returns the number of entries across all shards. Shards are visited
+ * one at a time, so under concurrent writes this is only a snapshot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+size_t ConcurrentHashMap<K, V, Hash, Pred, Alloc>::size() {
+  size_t total = 0;
+  for (size_t i = 0; i < _shard_count; i++) {
+    std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+    total += _shards[i]._map.size();
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the number of buckets across all shards
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+size_t ConcurrentHashMap<K, V, Hash, Pred, Alloc>::capacity() {
+  size_t total = 0;
+  for (size_t i = 0; i < _shard_count; i++) {
+    std::shared_lock<std::shared_mutex> lock(_shards[i]._mutex);
+    total += _shards[i]._map.capacity();
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the ratio of size / capacity across all shards
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+double ConcurrentHashMap<K, V, Hash, Pred, Alloc>::load_factor() {
+  return double(size()) / double(capacity());
+}
+
+/**
+ * @brief Returns the number of shards
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+size_t ConcurrentHashMap<K, V, Hash, Pred, Alloc>::shard_count() {
+  return _shard_count;
+}
+
+/**
+ * @brief Returns true if the map contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+bool ConcurrentHashMap<K, V, Hash, Pred, Alloc>::has(const K &key) {
+  Shard &s = shard(key);
+  std::shared_lock<std::shared_mutex> lock(s._mutex);
+  return s._map.has(key);
+}
+
+/**
+ * @brief Returns a copy of the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ * @return V
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+V ConcurrentHashMap<K, V, Hash, Pred, Alloc>::get(const K &key) {
+  Shard &s = shard(key);
+  std::shared_lock<std::shared_mutex> lock(s._mutex);
+  return s._map.get(key);
+}
+
+/**
+ * @brief Copies the value associated with key into value and returns true, or
+ * returns false if key is absent. This avoids the cost of an exception on the
+ * miss path
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ * @param value
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+bool ConcurrentHashMap<K, V, Hash, Pred, Alloc>::find(const K &key, V &value) {
+  Shard &s = shard(key);
+  std::shared_lock<std::shared_mutex> lock(s._mutex);
+  V *found = s._map.find(key);
+  if (!found) return false;
+  value = *found;
+  return true;
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+void ConcurrentHashMap<K, V, Hash, Pred, Alloc>::insert(const K &key,
+                                                        const V &value) {
+  Shard &s = shard(key);
+  std::unique_lock<std::shared_mutex> lock(s._mutex);
+  s._map.insert(key, value);
+}
+
+/**
+ * @brief Delete a key/value pair
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc>
+void ConcurrentHashMap<K, V, Hash, Pred, Alloc>::erase(const K &key) {
+  Shard &s = shard(key);
+  std::unique_lock<std::shared_mutex> lock(s._mutex);
+  s._map.erase(key);
+}
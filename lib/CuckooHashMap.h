@@ -0,0 +1,712 @@
+/**
+ * @file CuckooHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A bucketized cuckoo HashMap. Every key has exactly two candidate
+ * buckets, chosen by mixing its hash with two per-instance seeds. Each bucket
+ * is one 64-byte cache line holding up to four entries, as many as fit beside
+ * its occupancy byte: four for 8-byte entries such as int -> int, three for
+ * 16-byte ones such as uint64_t -> uint64_t. A lookup therefore reads at most
+ * two cache lines, plus a small stash while the stash is in use, and its cost
+ * does not depend on the table's contents. Entries of 64 bytes or more get
+ * one-way buckets that span several lines, so the bound does not hold for
+ * them.
+ *
+ * An insert whose buckets are both full evicts an entry to that entry's other
+ * bucket, and so on, for up to 128 evictions. If that fails, the homeless entry
+ * goes into a four-entry stash. If the stash is also full, the table doubles
+ * and rehashes with fresh seeds. Four-way buckets let the table fill to 95%,
+ * and narrower ones grow sooner.
+ *
+ * The public interface mirrors HashMapV1.h so the two can be swapped.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Hashing.h"
+
+/**
+ * @brief Returns how many entries of slot_size bytes, up to four, fit in a
+ * 64-byte CuckooHashMap bucket along with its occupancy byte. At least one
+ *
+ * @param slot_size
+ * @param slot_align
+ * @return unsigned
+ */
+constexpr unsigned cuckoo_bucket_width(size_t slot_size, size_t slot_align) {
+  for (unsigned width = 4; width > 1; width--) {
+    size_t bytes = width * slot_size + 1;
+    if ((bytes + slot_align - 1) / slot_align * slot_align <= 64) return width;
+  }
+  return 1;
+}
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class CuckooHashMap {
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    K _key;
+    V _val;
+
+    Slot(const K &, const V &);
+  };
+
+  class alignas(64) Bucket {
+   public:
+    alignas(Slot) unsigned char
+        _storage[cuckoo_bucket_width(sizeof(Slot), alignof(Slot)) *
+                 sizeof(Slot)];
+    uint8_t _occupied;
+
+    Slot *slot(unsigned);
+  };
+
+  /* Static Members */
+  static const unsigned _bucket_width =
+      cuckoo_bucket_width(sizeof(Slot), alignof(Slot));
+  static const unsigned _max_load_percent = _bucket_width == 4   ? 95
+                                            : _bucket_width == 3 ? 90
+                                            : _bucket_width == 2 ? 85
+                                                                 : 45;
+  static const size_t _min_buckets = 4;
+  static const size_t _stash_capacity = 4;
+  static const unsigned _max_kicks = 128;
+
+  static_assert(sizeof(Bucket) == 64 || _bucket_width == 1,
+                "a bucket of two or more entries is one cache line");
+
+  /* Members */
+  size_t _size;
+  size_t _bucket_count;
+  Bucket *_buckets;
+  size_t _stash_size;
+  alignas(Slot) unsigned char _stash[_stash_capacity * sizeof(Slot)];
+  uint64_t _seed_a;
+  uint64_t _seed_b;
+  uint64_t _random;
+
+  /* Helpers */
+  size_t bucket_a(uint64_t);
+  size_t bucket_b(uint64_t);
+  Slot *stash(size_t);
+  Slot *find(const K &);
+  bool put(size_t, Slot &);
+  void next_random();
+  bool place(Slot &);
+  bool plan(const std::vector<uint64_t> &, size_t, uint64_t, uint64_t,
+            std::vector<size_t> &, std::vector<size_t> &);
+  void rehash(size_t, Slot *);
+  void unstash();
+
+ public:
+  /* Constructors */
+  CuckooHashMap();
+  CuckooHashMap(const CuckooHashMap &) = delete;
+  CuckooHashMap &operator=(const CuckooHashMap &) = delete;
+  ~CuckooHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t capacity();
+  double load_factor();
+  size_t stash_size();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Construct a new Slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+CuckooHashMap<K, V, Hash, Pred>::Slot::Slot(const K &key, const V &value)
+    : _key(key), _val(value) {}
+
+/**
+ * @brief Returns the i-th slot of the bucket. It only holds an entry if bit i
+ * of _occupied is set
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ * @return Slot*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+typename CuckooHashMap<K, V, Hash, Pred>::Slot *
+CuckooHashMap<K, V, Hash, Pred>::Bucket::slot(unsigned i) {
+  return reinterpret_cast<Slot *>(_storage) + i;
+}
+
+/**
+ * @brief The first candidate bucket of a key with the given Hash output
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param h
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t CuckooHashMap<K, V, Hash, Pred>::bucket_a(uint64_t h) {
+  return mix_hash(h, _seed_a) & (_bucket_count - 1);
+}
+
+/**
+ * @brief The second candidate bucket of a key with the given Hash output
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param h
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t CuckooHashMap<K, V, Hash, Pred>::bucket_b(uint64_t h) {
+  return mix_hash(h, _seed_b) & (_bucket_count - 1);
+}
+
+/**
+ * @brief Returns the i-th stash slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ * @return Slot*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+typename CuckooHashMap<K, V, Hash, Pred>::Slot *
+CuckooHashMap<K, V, Hash, Pred>::stash(size_t i) {
+  return reinterpret_cast<Slot *>(_stash) + i;
+}
+
+/**
+ * @brief Returns the slot holding key, or nullptr if it is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return Slot*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+typename CuckooHashMap<K, V, Hash, Pred>::Slot *
+CuckooHashMap<K, V, Hash, Pred>::find(const K &key) {
+  if (!_size) return nullptr;
+
+  uint64_t h = Hash()(key);
+  size_t candidates[2] = {bucket_a(h), bucket_b(h)};
+
+  for (size_t b : candidates) {
+    Bucket &bucket = _buckets[b];
+    for (unsigned i = 0; i < _bucket_width; i++) {
+      if ((bucket._occupied >> i & 1) && Pred()(bucket.slot(i)->_key, key))
+        return bucket.slot(i);
+    }
+  }
+
+  for (size_t i = 0; i < _stash_size; i++) {
+    if (Pred()(stash(i)->_key, key)) return stash(i);
+  }
+
+  return nullptr;
+}
+
+/**
+ * @brief Moves carry into a free slot of bucket b, if there is one
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param b
+ * @param carry
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool CuckooHashMap<K, V, Hash, Pred>::put(size_t b, Slot &carry) {
+  Bucket &bucket = _buckets[b];
+  for (unsigned i = 0; i < _bucket_width; i++) {
+    if (bucket._occupied >> i & 1) continue;
+
+    new (bucket.slot(i)) Slot(std::move(carry));
+    bucket._occupied |= 1 << i;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Advances the xorshift state that picks eviction victims
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void CuckooHashMap<K, V, Hash, Pred>::next_random() {
+  _random ^= _random << 13;
+  _random ^= _random >> 7;
+  _random ^= _random << 17;
+}
+
+/**
+ * @brief Moves carry, whose key is absent, into the table or the stash. When
+ * both candidate buckets are full, a random resident of one is swapped out and
+ * carried to its other bucket, up to 128 times, before the stash is tried. On
+ * failure the evictions are undone in reverse, so carry and the table are as
+ * they were
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param carry moved from on success
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool CuckooHashMap<K, V, Hash, Pred>::place(Slot &carry) {
+  uint64_t h = Hash()(carry._key);
+  size_t a = bucket_a(h);
+  size_t b = bucket_b(h);
+
+  if (put(a, carry) || put(b, carry)) return true;
+
+  Slot *evicted[_max_kicks];
+  for (unsigned kick = 0; kick < _max_kicks; kick++) {
+    next_random();
+
+    size_t victim = _random & 1 ? a : b;
+    evicted[kick] = _buckets[victim].slot((_random >> 1) % _bucket_width);
+    std::swap(carry, *evicted[kick]);
+
+    h = Hash()(carry._key);
+    a = bucket_a(h);
+    b = bucket_b(h);
+    if (put(victim == a ? b : a, carry)) return true;
+  }
+
+  if (_stash_size == _stash_capacity) {
+    for (unsigned kick = _max_kicks; kick > 0; kick--)
+      std::swap(carry, *evicted[kick - 1]);
+    return false;
+  }
+
+  new (stash(_stash_size++)) Slot(std::move(carry));
+  return true;
+}
+
+/**
+ * @brief Works out where entries with the given hashes would go in a table of
+ * bucket_count buckets under the two seeds, with the same evictions place
+ * makes, but by index and without touching any entry. layout gets one entry
+ * index per bucket slot, hashes.size() where the slot is free, and stashed the
+ * indices of stashed entries. Returns false if some entry would be homeless
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param hashes
+ * @param bucket_count must be a power of two
+ * @param seed_a
+ * @param seed_b
+ * @param layout
+ * @param stashed
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool CuckooHashMap<K, V, Hash, Pred>::plan(const std::vector<uint64_t> &hashes,
+                                           size_t bucket_count, uint64_t seed_a,
+                                           uint64_t seed_b,
+                                           std::vector<size_t> &layout,
+                                           std::vector<size_t> &stashed) {
+  size_t n = hashes.size();
+  size_t mask = bucket_count - 1;
+  layout.assign(bucket_count * _bucket_width, n);
+  stashed.clear();
+
+  auto put_index = [&](size_t b, size_t entry) {
+    for (unsigned i = 0; i < _bucket_width; i++) {
+      size_t &slot = layout[b * _bucket_width + i];
+      if (slot != n) continue;
+      slot = entry;
+      return true;
+    }
+    return false;
+  };
+
+  for (size_t e = 0; e < n; e++) {
+    size_t carry = e;
+    size_t a = mix_hash(hashes[carry], seed_a) & mask;
+    size_t b = mix_hash(hashes[carry], seed_b) & mask;
+    if (put_index(a, carry) || put_index(b, carry)) continue;
+
+    bool placed = false;
+    for (unsigned kick = 0; kick < _max_kicks && !placed; kick++) {
+      next_random();
+
+      size_t victim = _random & 1 ? a : b;
+      std::swap(carry, layout[victim * _bucket_width +
+                              (_random >> 1) % _bucket_width]);
+
+      a = mix_hash(hashes[carry], seed_a) & mask;
+      b = mix_hash(hashes[carry], seed_b) & mask;
+      placed = put_index(victim == a ? b : a, carry);
+    }
+    if (placed) continue;
+
+    if (stashed.size() == _stash_capacity) return false;
+    stashed.push_back(carry);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Rebuilds the table with bucket_count buckets and fresh seeds, plus
+ * extra if it is given. The new layout is planned off to the side, and each
+ * failed plan doubles the bucket count and tries again with new seeds. Only a
+ * Hash that gives more than a dozen keys the same value can keep that from
+ * working. Once the table would be 64 times larger than its contents, this
+ * throws std::overflow_error. Entries only move once a plan succeeds and the
+ * new table is allocated, so on any throw the map still holds every entry it
+ * had and extra is left where it was
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param bucket_count must be a power of two
+ * @param extra an entry outside the table to include, or nullptr
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void CuckooHashMap<K, V, Hash, Pred>::rehash(size_t bucket_count,
+                                             Slot *extra) {
+  std::vector<Slot *> entries;
+  entries.reserve(_size + 1);
+  for (size_t b = 0; b < _bucket_count; b++) {
+    for (unsigned i = 0; i < _bucket_width; i++) {
+      if (_buckets[b]._occupied >> i & 1)
+        entries.push_back(_buckets[b].slot(i));
+    }
+  }
+  for (size_t i = 0; i < _stash_size; i++) entries.push_back(stash(i));
+  if (extra) entries.push_back(extra);
+
+  std::vector<uint64_t> hashes;
+  hashes.reserve(entries.size());
+  for (Slot *entry : entries) hashes.push_back(Hash()(entry->_key));
+
+  std::vector<size_t> layout;
+  std::vector<size_t> stashed;
+  uint64_t seed_a = random_seed();
+  uint64_t seed_b = random_seed();
+  while (!plan(hashes, bucket_count, seed_a, seed_b, layout, stashed)) {
+    bucket_count *= 2;
+    if (bucket_count * _bucket_width >= entries.size() * 64)
+      throw std::overflow_error("hash collisions");
+    seed_a = random_seed();
+    seed_b = random_seed();
+  }
+
+  Bucket *buckets = new Bucket[bucket_count]();
+
+  // the new stash reuses the old one's storage, so its residents step aside
+  alignas(Slot) unsigned char spill[_stash_capacity * sizeof(Slot)];
+  for (size_t i = 0; i < _stash_size; i++) {
+    Slot *&entry = entries[entries.size() - _stash_size - !!extra + i];
+    entry = new (reinterpret_cast<Slot *>(spill) + i) Slot(std::move(*entry));
+    stash(i)->~Slot();
+  }
+
+  auto take = [&](size_t e, Slot *dest) {
+    new (dest) Slot(std::move(*entries[e]));
+    if (entries[e] != extra) entries[e]->~Slot();
+  };
+
+  for (size_t b = 0; b < bucket_count; b++) {
+    for (unsigned i = 0; i < _bucket_width; i++) {
+      size_t e = layout[b * _bucket_width + i];
+      if (e == entries.size()) continue;
+      take(e, buckets[b].slot(i));
+      buckets[b]._occupied |= 1 << i;
+    }
+  }
+  for (size_t i = 0; i < stashed.size(); i++) take(stashed[i], stash(i));
+
+  delete[] _buckets;
+  _buckets = buckets;
+  _bucket_count = bucket_count;
+  _stash_size = stashed.size();
+  _seed_a = seed_a;
+  _seed_b = seed_b;
+}
+
+/**
+ * @brief After an erase frees a slot, moves stashed entries back into their
+ * buckets where possible, so that lookups can skip the stash again
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void CuckooHashMap<K, V, Hash, Pred>::unstash() {
+  for (size_t i = 0; i < _stash_size;) {
+    uint64_t h = Hash()(stash(i)->_key);
+    if (!put(bucket_a(h), *stash(i)) && !put(bucket_b(h), *stash(i))) {
+      i++;
+      continue;
+    }
+
+    stash(i)->~Slot();
+    if (i != --_stash_size) {
+      new (stash(i)) Slot(std::move(*stash(_stash_size)));
+      stash(_stash_size)->~Slot();
+    }
+  }
+}
+
+/**
+ * @brief Construct a new CuckooHashMap object. No storage is allocated until
+ * the first insert
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+CuckooHashMap<K, V, Hash, Pred>::CuckooHashMap()
+    : _size(0),
+      _bucket_count(0),
+      _buckets(nullptr),
+      _stash_size(0),
+      _seed_a(random_seed()),
+      _seed_b(random_seed()),
+      _random(random_seed() | 1) {}
+
+/**
+ * @brief Destroy the CuckooHashMap object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+CuckooHashMap<K, V, Hash, Pred>::~CuckooHashMap() {
+  for (size_t b = 0; b < _bucket_count; b++) {
+    for (unsigned i = 0; i < _bucket_width; i++) {
+      if (_buckets[b]._occupied >> i & 1) _buckets[b].slot(i)->~Slot();
+    }
+  }
+  for (size_t i = 0; i < _stash_size; i++) stash(i)->~Slot();
+  delete[] _buckets;
+}
+
+/**
+ * @brief Returns true if CuckooHashMap is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool CuckooHashMap<K, V, Hash, Pred>::is_empty() {
+  return !_size;
+}
+
+/**
+ * @brief Returns the number of entries stored in the CuckooHashMap, including
+ * stashed ones
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t CuckooHashMap<K, V, Hash, Pred>::size() {
+  return _size;
+}
+
+/**
+ * @brief Returns the number of bucket slots, up to four per bucket
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t CuckooHashMap<K, V, Hash, Pred>::capacity() {
+  return _bucket_count * _bucket_width;
+}
+
+/**
+ * @brief Returns the ratio of size / capacity
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+double CuckooHashMap<K, V, Hash, Pred>::load_factor() {
+  return double(_size) / double(capacity());
+}
+
+/**
+ * @brief Returns the number of entries waiting in the stash
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t CuckooHashMap<K, V, Hash, Pred>::stash_size() {
+  return _stash_size;
+}
+
+/**
+ * @brief Returns true if CuckooHashMap contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool CuckooHashMap<K, V, Hash, Pred>::has(const K &key) {
+  return find(key);
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V &CuckooHashMap<K, V, Hash, Pred>::get(const K &key) {
+  Slot *slot = find(key);
+  if (!slot) throw std::out_of_range("key not found");
+  return slot->_val;
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair. The table doubles ahead of time
+ * once it is 95% full (less for buckets under four wide), and also whenever
+ * placing the new entry fails
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void CuckooHashMap<K, V, Hash, Pred>::insert(const K &key, const V &value) {
+  Slot *slot = find(key);
+  if (slot) {
+    slot->_val = value;
+    return;
+  }
+
+  if (!_bucket_count) {
+    _bucket_count = _min_buckets;
+    _buckets = new Bucket[_bucket_count]();
+  } else if ((_size + 1) * 100 > capacity() * _max_load_percent) {
+    rehash(_bucket_count * 2, nullptr);
+  }
+
+  Slot carry(key, value);
+  if (!place(carry)) rehash(_bucket_count * 2, &carry);
+  _size++;
+}
+
+/**
+ * @brief Delete a key/value pair
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void CuckooHashMap<K, V, Hash, Pred>::erase(const K &key) {
+  Slot *slot = find(key);
+  if (!slot) return;
+
+  slot->~Slot();
+  _size--;
+
+  if (slot >= stash(0) && slot < stash(_stash_capacity)) {
+    size_t i = slot - stash(0);
+    if (i != --_stash_size) {
+      new (slot) Slot(std::move(*stash(_stash_size)));
+      stash(_stash_size)->~Slot();
+    }
+    return;
+  }
+
+  Bucket &bucket = _buckets[(reinterpret_cast<unsigned char *>(slot) -
+                             reinterpret_cast<unsigned char *>(_buckets)) /
+                            sizeof(Bucket)];
+  bucket._occupied &= ~(1 << (slot - bucket.slot(0)));
+
+  if (_stash_size) unstash();
+}
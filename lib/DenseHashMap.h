@@ -0,0 +1,472 @@
+/**
+ * @file DenseHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A HashMap whose entries live contiguously in a Vector, in insertion
+ * order. The hash table itself holds only 32-bit positions into that Vector,
+ * using linear probing. Compared with the chained HashMap:
+ *
+ * - iteration streams through one array, with no pointer chasing and no empty
+ *   buckets to skip
+ * - each entry costs its key, value and cached hash, plus its share of the
+ *   table: one 4-byte position per slot, at a load factor between 0.375 just
+ *   after doubling and the 0.75 maximum, so about 5.3 to 10.7 bytes per entry
+ *   (more after erases, since the table never shrinks)
+ * - clear drops every entry in one step
+ *
+ * erase moves the last entry into the erased one's position, so after an
+ * erase the order is no longer pure insertion order. Positions 0 to size() - 1
+ * are always filled.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "Hashing.h"
+#include "Vector.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class DenseHashMap {
+ private:
+  /* Inner Classes */
+  class Entry {
+   public:
+    K _key;
+    V _val;
+    uint64_t _hash;
+
+    Entry(const K &, const V &, uint64_t);
+  };
+
+  /* Static Members */
+  static const uint32_t _empty = UINT32_MAX;
+  static const size_t _min_capacity = 8;
+
+  /* Members */
+  Vector<Entry> _entries;
+  uint32_t *_indices;
+  size_t _capacity;
+  uint64_t _seed;
+
+  /* Helpers */
+  size_t find_slot(const K &, uint64_t);
+  void place(uint32_t);
+  void resize(size_t);
+  void erase_slot(size_t);
+
+ public:
+  /* Constructors */
+  DenseHashMap();
+  DenseHashMap(const DenseHashMap &) = delete;
+  DenseHashMap &operator=(const DenseHashMap &) = delete;
+  ~DenseHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t capacity();
+  double load_factor();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+  V *find(const K &);
+  const K &key_at(size_t);
+  V &value_at(size_t);
+  template <typename F>
+  void for_each(F &&);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+  void clear();
+};
+
+/**
+ * @brief Construct a new Entry
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ * @param hashed_key
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+DenseHashMap<K, V, Hash, Pred>::Entry::Entry(const K &key, const V &value,
+                                             uint64_t hashed_key)
+    : _key(key), _val(value), _hash(hashed_key) {}
+
+/**
+ * @brief Returns the table slot that holds key's position, or _capacity if key
+ * is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param hashed_key
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t DenseHashMap<K, V, Hash, Pred>::find_slot(const K &key,
+                                                 uint64_t hashed_key) {
+  if (!_capacity) return _capacity;
+
+  Entry *entries = _entries.data();
+  size_t mask = _capacity - 1;
+
+  for (size_t slot = hashed_key & mask;; slot = (slot + 1) & mask) {
+    uint32_t i = _indices[slot];
+    if (i == _empty) return _capacity;
+    if (entries[i]._hash == hashed_key && Pred()(entries[i]._key, key))
+      return slot;
+  }
+}
+
+/**
+ * @brief Records entry i's position in the first free slot of its probe
+ * sequence
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::place(uint32_t i) {
+  size_t mask = _capacity - 1;
+  size_t slot = _entries.data()[i]._hash & mask;
+
+  while (_indices[slot] != _empty) slot = (slot + 1) & mask;
+  _indices[slot] = i;
+}
+
+/**
+ * @brief Rebuilds the table with new_capacity slots. Entries do not move, and
+ * their cached hashes mean no key is hashed again
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param new_capacity must be a power of two
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::resize(size_t new_capacity) {
+  free(_indices);
+
+  _capacity = new_capacity;
+  _indices = (uint32_t *)malloc(_capacity * sizeof(uint32_t));
+  memset(_indices, 0xFF, _capacity * sizeof(uint32_t));
+
+  for (size_t i = 0; i < _entries.size(); i++) place(uint32_t(i));
+}
+
+/**
+ * @brief Empties a table slot. Each following slot whose entry could have
+ * used the hole is moved back into it, so probes never need tombstones
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param hole
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::erase_slot(size_t hole) {
+  Entry *entries = _entries.data();
+  size_t mask = _capacity - 1;
+
+  for (size_t slot = (hole + 1) & mask; _indices[slot] != _empty;
+       slot = (slot + 1) & mask) {
+    size_t home = entries[_indices[slot]]._hash & mask;
+
+    // the entry may move back only if its home is not in (hole, slot]
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      _indices[hole] = _indices[slot];
+      hole = slot;
+    }
+  }
+
+  _indices[hole] = _empty;
+}
+
+/**
+ * @brief Construct a new DenseHashMap object. No storage is allocated until
+ * the first insert
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+DenseHashMap<K, V, Hash, Pred>::DenseHashMap()
+    : _indices(nullptr), _capacity(0), _seed(random_seed()) {}
+
+/**
+ * @brief Destroy the DenseHashMap object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+DenseHashMap<K, V, Hash, Pred>::~DenseHashMap() {
+  free(_indices);
+}
+
+/**
+ * @brief Returns true if DenseHashMap is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool DenseHashMap<K, V, Hash, Pred>::is_empty() {
+  return _entries.is_empty();
+}
+
+/**
+ * @brief Returns the number of entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t DenseHashMap<K, V, Hash, Pred>::size() {
+  return _entries.size();
+}
+
+/**
+ * @brief Returns the number of table slots
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t DenseHashMap<K, V, Hash, Pred>::capacity() {
+  return _capacity;
+}
+
+/**
+ * @brief Returns the ratio of size / capacity
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+double DenseHashMap<K, V, Hash, Pred>::load_factor() {
+  return double(_entries.size()) / double(_capacity);
+}
+
+/**
+ * @brief Returns true if DenseHashMap contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool DenseHashMap<K, V, Hash, Pred>::has(const K &key) {
+  return find_slot(key, mix_hash(Hash()(key), _seed)) != _capacity;
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V &DenseHashMap<K, V, Hash, Pred>::get(const K &key) {
+  V *value = find(key);
+  if (!value) throw std::out_of_range("key not found");
+  return *value;
+}
+
+/**
+ * @brief Returns a pointer to the value associated with the provided key, or
+ * nullptr if it is absent. The pointer is valid until the next insert or erase
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V *DenseHashMap<K, V, Hash, Pred>::find(const K &key) {
+  size_t slot = find_slot(key, mix_hash(Hash()(key), _seed));
+  if (slot == _capacity) return nullptr;
+  return &_entries.data()[_indices[slot]]._val;
+}
+
+/**
+ * @brief Returns the key of the entry at position i
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ * @return const K&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+const K &DenseHashMap<K, V, Hash, Pred>::key_at(size_t i) {
+  if (i >= _entries.size()) throw std::invalid_argument("index out of bounds");
+  return _entries.data()[i]._key;
+}
+
+/**
+ * @brief Returns the value of the entry at position i
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V &DenseHashMap<K, V, Hash, Pred>::value_at(size_t i) {
+  if (i >= _entries.size()) throw std::invalid_argument("index out of bounds");
+  return _entries.data()[i]._val;
+}
+
+/**
+ * @brief Calls visit(key, value) for every entry, in position order. visit
+ * must not insert into or erase from the DenseHashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam F callable as void(const K &, V &)
+ * @param visit
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+template <typename F>
+void DenseHashMap<K, V, Hash, Pred>::for_each(F &&visit) {
+  Entry *entries = _entries.data();
+  for (size_t i = 0; i < _entries.size(); i++)
+    visit(entries[i]._key, entries[i]._val);
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair. A new key is appended after
+ * every existing entry. The table doubles once it would pass a 0.75 load
+ * factor
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::insert(const K &key, const V &value) {
+  uint64_t hashed_key = mix_hash(Hash()(key), _seed);
+  size_t slot = find_slot(key, hashed_key);
+  if (slot != _capacity) {
+    _entries.data()[_indices[slot]]._val = value;
+    return;
+  }
+
+  size_t size = _entries.size();
+  if (size == _empty) throw std::length_error("too many entries");
+
+  if (!_capacity) {
+    resize(_min_capacity);
+  } else if ((size + 1) * 4 > _capacity * 3) {
+    resize(_capacity * 2);
+  }
+
+  _entries.emplace_back(key, value, hashed_key);
+  place(uint32_t(size));
+}
+
+/**
+ * @brief Delete a key/value pair. The last entry moves into its position
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::erase(const K &key) {
+  size_t slot = find_slot(key, mix_hash(Hash()(key), _seed));
+  if (slot == _capacity) return;
+
+  uint32_t i = _indices[slot];
+  uint32_t last = uint32_t(_entries.size() - 1);
+  erase_slot(slot);
+
+  if (i != last) {
+    Entry *entries = _entries.data();
+    size_t mask = _capacity - 1;
+
+    size_t moved = entries[last]._hash & mask;
+    while (_indices[moved] != last) moved = (moved + 1) & mask;
+    _indices[moved] = i;
+
+    entries[i] = std::move(entries[last]);
+  }
+
+  _entries.pop_back();
+}
+
+/**
+ * @brief Delete every entry. The table keeps its capacity, and the entry
+ * storage is released
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void DenseHashMap<K, V, Hash, Pred>::clear() {
+  _entries.clear();
+  if (_capacity) memset(_indices, 0xFF, _capacity * sizeof(uint32_t));
+}
@@ -0,0 +1,61 @@
+/**
+ * @file EmptyBase.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief Storage for the allocators and policies that containers in this
+ * library are parameterized on. Most of them, such as std::allocator,
+ * MallocAllocator and NoHashMapStats, are empty classes, yet a plain member of
+ * an empty type still takes a byte and is padded out to the next member's
+ * alignment. A container that derives from EmptyBase<T> instead gets the empty
+ * base optimization, so a stateless T costs nothing.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Holds a T. When T is an empty class that can be derived from,
+ * EmptyBase derives from it instead of storing it, and takes no space as a
+ * base. Tag tells apart several EmptyBases of one class, which reach their
+ * value through a qualified EmptyBase<T, Tag>::get()
+ *
+ * @tparam T
+ * @tparam Tag
+ * @tparam Empty
+ */
+template <typename T, int Tag = 0,
+          bool Empty = std::is_empty<T>::value && !std::is_final<T>::value>
+class EmptyBase {
+ private:
+  /* Members */
+  T _value;
+
+ public:
+  /* Constructors */
+  EmptyBase() : _value() {}
+  explicit EmptyBase(const T &value) : _value(value) {}
+  explicit EmptyBase(T &&value) : _value(std::move(value)) {}
+
+  /* Accessors */
+  T &get() { return _value; }
+  const T &get() const { return _value; }
+};
+
+template <typename T, int Tag>
+class EmptyBase<T, Tag, true> : private T {
+ public:
+  /* Constructors */
+  EmptyBase() : T() {}
+  explicit EmptyBase(const T &value) : T(value) {}
+  explicit EmptyBase(T &&value) : T(std::move(value)) {}
+
+  /* Accessors */
+  T &get() { return *this; }
+  const T &get() const { return *this; }
+};
@@ -0,0 +1,406 @@
+/**
+ * @file FrozenHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief An immutable HashMap for data that is built once and then only read.
+ * Construction finds a minimal perfect hash function for the keys, using the
+ * hash-and-displace method. Keys are split into buckets averaging two keys
+ * each. Then, largest bucket first, each bucket searches for a displacement
+ * that sends all of its keys to free positions. Buckets of one key simply take
+ * a free position directly.
+ *
+ * The entries sit in a single dense array, with no empty slots and no chain
+ * pointers. A lookup hashes the key, reads one 32-bit displacement and probes
+ * exactly one entry. Memory use is size * sizeof(entry) plus two bytes per key
+ * for the displacements.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "HashMapV1.h"
+#include "Hashing.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class FrozenHashMap {
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    K _key;
+    V _val;
+
+    Slot(const K &, const V &);
+  };
+
+  /* Static Members */
+  static const uint32_t _direct = uint32_t(1) << 31;
+  static const uint32_t _max_displacement = 1 << 16;
+  static const unsigned _max_attempts = 8;
+
+  /* Members */
+  size_t _size;
+  std::vector<Slot> _entries;
+  std::vector<uint32_t> _displacements;
+  uint64_t _seed;
+
+  /* Helpers */
+  size_t bucket(uint64_t) const;
+  size_t position(uint64_t, uint32_t) const;
+  const Slot *find(const K &) const;
+  bool displace(const std::vector<uint64_t> &, std::vector<size_t> &);
+  void build(std::vector<Slot> &);
+
+ public:
+  /* Constructors */
+  FrozenHashMap();
+  template <typename Alloc, typename Stats>
+  explicit FrozenHashMap(HashMap<K, V, Hash, Pred, Alloc, Stats> &);
+  template <typename InputIt>
+  FrozenHashMap(InputIt, InputIt);
+
+  /* Util */
+  bool is_empty() const;
+  size_t size() const;
+  bool has(const K &) const;
+
+  /* Accessors */
+  const V &get(const K &) const;
+};
+
+/**
+ * @brief Construct a new Slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+FrozenHashMap<K, V, Hash, Pred>::Slot::Slot(const K &key, const V &value)
+    : _key(key), _val(value) {}
+
+/**
+ * @brief Returns the bucket of a key with the given Hash output
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param h
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t FrozenHashMap<K, V, Hash, Pred>::bucket(uint64_t h) const {
+  return mix_hash(h, _seed) % _displacements.size();
+}
+
+/**
+ * @brief Returns the position of a key with the given Hash output, once its
+ * bucket has chosen displacement d
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param h
+ * @param d
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t FrozenHashMap<K, V, Hash, Pred>::position(uint64_t h, uint32_t d) const {
+  return mix_hash(h, _seed + 1 + d) % _size;
+}
+
+/**
+ * @brief Returns the entry holding key, or nullptr if it is absent. A key that
+ * was not in the build set still maps to some entry, so the key stored there
+ * is compared
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return const Slot*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+const typename FrozenHashMap<K, V, Hash, Pred>::Slot *
+FrozenHashMap<K, V, Hash, Pred>::find(const K &key) const {
+  if (!_size) return nullptr;
+
+  uint64_t h = Hash()(key);
+  uint32_t d = _displacements[bucket(h)];
+  const Slot &slot = _entries[d & _direct ? d & ~_direct : position(h, d)];
+
+  return Pred()(slot._key, key) ? &slot : nullptr;
+}
+
+/**
+ * @brief Searches for a displacement for every bucket with the current seed.
+ * On success, order[p] is the index into hashes of the key placed at p
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param hashes the Hash output of every key
+ * @param order
+ * @return boolean false if some bucket found no displacement
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool FrozenHashMap<K, V, Hash, Pred>::displace(
+    const std::vector<uint64_t> &hashes, std::vector<size_t> &order) {
+  size_t n = hashes.size();
+  size_t buckets = _displacements.size();
+
+  // counting sort of the keys by bucket
+  std::vector<size_t> starts(buckets + 1, 0);
+  for (uint64_t h : hashes) starts[bucket(h) + 1]++;
+  for (size_t b = 0; b < buckets; b++) starts[b + 1] += starts[b];
+
+  std::vector<size_t> members(n);
+  std::vector<size_t> cursor(starts.begin(), starts.end() - 1);
+  for (size_t i = 0; i < n; i++) members[cursor[bucket(hashes[i])]++] = i;
+
+  std::vector<size_t> by_size(buckets);
+  for (size_t b = 0; b < buckets; b++) by_size[b] = b;
+  std::sort(by_size.begin(), by_size.end(), [&](size_t a, size_t b) {
+    return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+  });
+
+  const size_t unset = n;
+  order.assign(n, unset);
+  std::vector<size_t> taken;
+  size_t next_free = 0;
+
+  for (size_t b : by_size) {
+    size_t first = starts[b];
+    size_t count = starts[b + 1] - first;
+
+    if (count <= 1) {
+      _displacements[b] = 0;
+      if (!count) continue;
+
+      while (order[next_free] != unset) next_free++;
+      order[next_free] = members[first];
+      _displacements[b] = _direct | uint32_t(next_free);
+      continue;
+    }
+
+    uint32_t d = 0;
+    for (; d < _max_displacement; d++) {
+      taken.clear();
+      for (size_t i = first; i < first + count; i++) {
+        size_t p = position(hashes[members[i]], d);
+        if (order[p] != unset) break;
+        order[p] = members[i];
+        taken.push_back(p);
+      }
+      if (taken.size() == count) break;
+
+      for (size_t p : taken) order[p] = unset;
+    }
+
+    if (d == _max_displacement) return false;
+    _displacements[b] = d;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Finds a minimal perfect hash function for the keys of items, which
+ * must be distinct, and moves items into place. Each failed search starts over
+ * with a new seed. Keys that collide in all 64 bits of Hash can never be
+ * separated, so after 8 failures this throws std::overflow_error
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param items
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void FrozenHashMap<K, V, Hash, Pred>::build(std::vector<Slot> &items) {
+  size_t n = items.size();
+  if (!n) return;
+  if (n >= _direct) throw std::length_error("too many keys");
+
+  std::vector<uint64_t> hashes(n);
+  for (size_t i = 0; i < n; i++) hashes[i] = Hash()(items[i]._key);
+
+  _size = n;
+  std::vector<size_t> order;
+  _displacements.assign((n + 1) / 2, 0);
+
+  for (unsigned attempt = 0;; attempt++) {
+    if (attempt == _max_attempts) {
+      _size = 0;
+      _displacements.clear();
+      throw std::overflow_error("hash collisions");
+    }
+
+    _seed = random_seed();
+    if (displace(hashes, order)) break;
+  }
+
+  _entries.reserve(n);
+  for (size_t p = 0; p < n; p++) _entries.push_back(std::move(items[order[p]]));
+}
+
+/**
+ * @brief Construct an empty FrozenHashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+FrozenHashMap<K, V, Hash, Pred>::FrozenHashMap() : _size(0), _seed(0) {}
+
+/**
+ * @brief Construct a FrozenHashMap holding a copy of every entry of map
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param map
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+template <typename Alloc, typename Stats>
+FrozenHashMap<K, V, Hash, Pred>::FrozenHashMap(
+    HashMap<K, V, Hash, Pred, Alloc, Stats> &map)
+    : _size(0), _seed(0) {
+  std::vector<Slot> items;
+  items.reserve(map.size());
+  map.for_each(
+      [&](const K &key, V &value) { items.push_back(Slot(key, value)); });
+  build(items);
+}
+
+/**
+ * @brief Construct a FrozenHashMap from a range of key/value pairs, such as
+ * std::pair or std::map entries. If a key appears more than once, the last
+ * value wins, as if each pair had been inserted into a HashMap in order
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam InputIt iterator to a type with first and second members
+ * @param first
+ * @param last
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+template <typename InputIt>
+FrozenHashMap<K, V, Hash, Pred>::FrozenHashMap(InputIt first, InputIt last)
+    : _size(0), _seed(0) {
+  std::vector<Slot> items;
+  for (; first != last; ++first)
+    items.push_back(Slot(first->first, first->second));
+
+  // group equal keys by sorting on the Hash output, keeping the order of
+  // insertion within a group
+  std::vector<std::pair<uint64_t, size_t> > keyed(items.size());
+  for (size_t i = 0; i < items.size(); i++)
+    keyed[i] = std::make_pair(uint64_t(Hash()(items[i]._key)), i);
+  std::sort(keyed.begin(), keyed.end());
+
+  std::vector<bool> overwritten(items.size(), false);
+  for (size_t i = 0; i < keyed.size(); i++) {
+    for (size_t j = i + 1;
+         j < keyed.size() && keyed[j].first == keyed[i].first; j++) {
+      if (Pred()(items[keyed[i].second]._key, items[keyed[j].second]._key)) {
+        overwritten[keyed[i].second] = true;
+        break;
+      }
+    }
+  }
+
+  std::vector<Slot> unique;
+  unique.reserve(items.size());
+  for (size_t i = 0; i < items.size(); i++) {
+    if (!overwritten[i]) unique.push_back(std::move(items[i]));
+  }
+
+  build(unique);
+}
+
+/**
+ * @brief Returns true if FrozenHashMap is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool FrozenHashMap<K, V, Hash, Pred>::is_empty() const {
+  return !_size;
+}
+
+/**
+ * @brief Returns the number of entries, which is also the number of slots
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t FrozenHashMap<K, V, Hash, Pred>::size() const {
+  return _size;
+}
+
+/**
+ * @brief Returns true if FrozenHashMap contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool FrozenHashMap<K, V, Hash, Pred>::has(const K &key) const {
+  return find(key);
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return const V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+const V &FrozenHashMap<K, V, Hash, Pred>::get(const K &key) const {
+  const Slot *slot = find(key);
+  if (!slot) throw std::out_of_range("key not found");
+  return slot->_val;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file HashMapStats.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief Statistics policies for HashMap, chosen through its Stats template
+ * parameter. HashMap reports events to the policy as they happen: how many
+ * nodes each lookup and insert compared, each resize, and each allocation.
+ *
+ * NoHashMapStats is the default. Its hooks are empty inline functions, and
+ * HashMap holds the policy as an empty base, so a HashMap that does not ask
+ * for statistics compiles to the same code, and the policy takes no space in
+ * it. HashMapStats keeps counters that a metrics exporter can read through
+ * HashMap::stats(). Neither policy is thread-safe.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+class NoHashMapStats {
+ public:
+  /* Mutators */
+  void on_lookup(size_t) {}
+  void on_insert(size_t) {}
+  void on_rehash_begin() {}
+  void on_rehash_end() {}
+  void on_allocate(size_t) {}
+  void on_deallocate(size_t) {}
+};
+
+class HashMapStats {
+ private:
+  /* Members */
+  uint64_t _lookups;
+  uint64_t _lookup_probes;
+  uint64_t _max_lookup_probes;
+  uint64_t _inserts;
+  uint64_t _insert_probes;
+  uint64_t _max_insert_probes;
+  uint64_t _rehashes;
+  std::chrono::steady_clock::duration _rehash_time;
+  std::chrono::steady_clock::time_point _rehash_start;
+  uint64_t _bytes_allocated;
+  uint64_t _peak_bytes_allocated;
+
+ public:
+  /* Constructors */
+  HashMapStats();
+
+  /* Accessors */
+  uint64_t lookups() const;
+  double average_lookup_probes() const;
+  uint64_t max_lookup_probes() const;
+  uint64_t inserts() const;
+  double average_insert_probes() const;
+  uint64_t max_insert_probes() const;
+  uint64_t rehashes() const;
+  std::chrono::steady_clock::duration rehash_time() const;
+  uint64_t bytes_allocated() const;
+  uint64_t peak_bytes_allocated() const;
+
+  /* Mutators */
+  void on_lookup(size_t);
+  void on_insert(size_t);
+  void on_rehash_begin();
+  void on_rehash_end();
+  void on_allocate(size_t);
+  void on_deallocate(size_t);
+  void reset();
+};
+
+/**
+ * @brief Construct a HashMapStats with every counter at zero
+ */
+inline HashMapStats::HashMapStats() : _bytes_allocated(0) { reset(); }
+
+/**
+ * @brief Returns the number of get, has and find calls, counting each key of a
+ * find_batch
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::lookups() const { return _lookups; }
+
+/**
+ * @brief Returns the mean number of nodes compared per lookup. Values well
+ * above 1 at a normal load factor point to a weak Hash
+ *
+ * @return double
+ */
+inline double HashMapStats::average_lookup_probes() const {
+  return _lookups ? double(_lookup_probes) / double(_lookups) : 0;
+}
+
+/**
+ * @brief Returns the most nodes compared by any one lookup
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::max_lookup_probes() const {
+  return _max_lookup_probes;
+}
+
+/**
+ * @brief Returns the number of inserts, including ones that found the key
+ * already present
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::inserts() const { return _inserts; }
+
+/**
+ * @brief Returns the mean number of nodes compared while checking whether an
+ * inserted key was already present
+ *
+ * @return double
+ */
+inline double HashMapStats::average_insert_probes() const {
+  return _inserts ? double(_insert_probes) / double(_inserts) : 0;
+}
+
+/**
+ * @brief Returns the most nodes compared by any one insert
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::max_insert_probes() const {
+  return _max_insert_probes;
+}
+
+/**
+ * @brief Returns the number of times the table has been resized
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::rehashes() const { return _rehashes; }
+
+/**
+ * @brief Returns the total time spent resizing the table. With incremental
+ * rehashing this covers only the allocation, not the later migration steps
+ *
+ * @return std::chrono::steady_clock::duration
+ */
+inline std::chrono::steady_clock::duration HashMapStats::rehash_time() const {
+  return _rehash_time;
+}
+
+/**
+ * @brief Returns the bytes currently allocated for nodes and bucket arrays
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::bytes_allocated() const {
+  return _bytes_allocated;
+}
+
+/**
+ * @brief Returns the most bytes ever allocated at once, which includes both
+ * bucket arrays during a resize
+ *
+ * @return uint64_t
+ */
+inline uint64_t HashMapStats::peak_bytes_allocated() const {
+  return _peak_bytes_allocated;
+}
+
+/**
+ * @brief Record a lookup that compared probes nodes
+ *
+ * @param probes
+ */
+inline void HashMapStats::on_lookup(size_t probes) {
+  _lookups++;
+  _lookup_probes += probes;
+  if (probes > _max_lookup_probes) _max_lookup_probes = probes;
+}
+
+/**
+ * @brief Record an insert that compared probes nodes
+ *
+ * @param probes
+ */
+inline void HashMapStats::on_insert(size_t probes) {
+  _inserts++;
+  _insert_probes += probes;
+  if (probes > _max_insert_probes) _max_insert_probes = probes;
+}
+
+/**
+ * @brief Record the start of a resize
+ */
+inline void HashMapStats::on_rehash_begin() {
+  _rehash_start = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Record the end of the resize begun by on_rehash_begin
+ */
+inline void HashMapStats::on_rehash_end() {
+  _rehashes++;
+  _rehash_time += std::chrono::steady_clock::now() - _rehash_start;
+}
+
+/**
+ * @brief Record an allocation of bytes
+ *
+ * @param bytes
+ */
+inline void HashMapStats::on_allocate(size_t bytes) {
+  _bytes_allocated += bytes;
+  if (_bytes_allocated > _peak_bytes_allocated)
+    _peak_bytes_allocated = _bytes_allocated;
+}
+
+/**
+ * @brief Record the release of bytes
+ *
+ * @param bytes
+ */
+inline void HashMapStats::on_deallocate(size_t bytes) {
+  _bytes_allocated -= bytes;
+}
+
+/**
+ * @brief Zero the event counters. The allocation figures describe the map's
+ * current state, so they are kept, with the peak lowered to the current value
+ */
+inline void HashMapStats::reset() {
+  _lookups = 0;
+  _lookup_probes = 0;
+  _max_lookup_probes = 0;
+  _inserts = 0;
+  _insert_probes = 0;
+  _max_insert_probes = 0;
+  _rehashes = 0;
+  _rehash_time = std::chrono::steady_clock::duration::zero();
+  _peak_bytes_allocated = _bytes_allocated;
+}
@@ -2,8 +2,9 @@
  * @file HashMapV1.h
  * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
  * @brief An implementation of a HashMap using chaining to resolve
- * collisions. Implements a universal hashing function as seen in Introduction
- * to Algorithms, 3rd ed.
+ * collisions. Keys are hashed with a seeded multiply-xorshift mixer (see
+ * Hashing.h) and bucketed with a mask, since the capacity is always a power of
+ * two.
  * @version 0.1
  * @date 2022-06-10
  *
@@ -13,46 +14,185 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
 #include <functional>
-#include <random>
+#include <memory>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BloomFilter.h"
+#include "EmptyBase.h"
+#include "HashMapStats.h"
+#include "Hashing.h"
+
+/**
+ * @brief Detects functors that opt into heterogeneous lookup by declaring an
+ * is_transparent member type, like std::equal_to<void>
+ *
+ * @tparam T
+ */
+template <typename T, typename = void>
+class IsTransparent : public std::false_type {};
+
+template <typename T>
+class IsTransparent<T, std::void_t<typename T::is_transparent> >
+    : public std::true_type {};
+
+/**
+ * @brief Whether HashMap nodes keep the full hash of their key. A cached hash
+ * lets a resize move nodes without calling Hash again, and lets a chain walk
+ * skip Pred on nodes whose hash differs. It costs 8 bytes per node, so it is
+ * on by default only for keys that are not arithmetic, such as strings.
+ * Specialize this for a key type to override the default
+ *
+ * @tparam K
+ */
+template <typename K>
+class HashMapCacheHash
+    : public std::integral_constant<bool, !std::is_arithmetic<K>::value> {};
+
+/**
+ * @brief Base of a HashMap node. CachedHash<true> stores the hash, and the
+ * empty CachedHash<false> adds nothing to the node
+ *
+ * @tparam Cached
+ */
+template <bool Cached>
+class CachedHash {
+ public:
+  uint64_t _hash;
+};
+
+template <>
+class CachedHash<false> {};
+
+/**
+ * @brief KeyArg<true>::type<Q, K> is Q and KeyArg<false>::type<Q, K> is K. A
+ * lookup declared as template <typename Q = K> f(const key_arg<Q> &) will
+ * deduce Q from its argument only when the map's functors are transparent.
+ * Otherwise the argument is converted to K as before
+ *
+ * @tparam Transparent
+ */
+template <bool Transparent>
+class KeyArg {
+ public:
+  template <typename Q, typename Key>
+  using type = Key;
+};
+
+template <>
+class KeyArg<true> {
+ public:
+  template <typename Q, typename Key>
+  using type = Q;
+};
 
 template <typename K, typename V, typename Hash = std::hash<K>,
-          typename Pred = std::equal_to<K> >
+          typename Pred = std::equal_to<K>,
+          typename Alloc = std::allocator<std::pair<const K, V> >,
+          typename Stats = NoHashMapStats>
 class HashMap {
  private:
+  static const bool _cache_hash = HashMapCacheHash<K>::value;
+
   /* Inner Classes */
-  class Node {
+  class Node : public CachedHash<_cache_hash> {
    public:
     const K _key;
     V _val;
     Node *_next;
 
-    Node(const K &, const V &);
+    template <typename KArg, typename... Args>
+    Node(KArg &&, Args &&...);
     ~Node();
   };
 
+  /* Typedefs */
+  typedef std::allocator_traits<Alloc> AllocTraits;
+  typedef typename AllocTraits::template rebind_alloc<Node> NodeAlloc;
+  typedef typename AllocTraits::template rebind_alloc<Node *> TableAlloc;
+  typedef std::allocator_traits<NodeAlloc> NodeTraits;
+  typedef std::allocator_traits<TableAlloc> TableTraits;
+
+  /**
+   * @brief The seed, together with the allocators and the statistics policy.
+   * Those are held through EmptyBase, so when they are stateless, as
+   * std::allocator and NoHashMapStats are, they add nothing to the map
+   */
+  class Policies : public EmptyBase<NodeAlloc, 0>,
+                   public EmptyBase<TableAlloc, 1>,
+                   public EmptyBase<Stats, 2> {
+   public:
+    uint64_t _seed;
+
+    Policies();
+    explicit Policies(const Alloc &);
+  };
+
+  static const bool _transparent =
+      IsTransparent<Hash>::value && IsTransparent<Pred>::value;
+
+  template <typename Q>
+  using key_arg = typename KeyArg<_transparent>::template type<Q, K>;
+
   /* Static Members */
-  static const size_t _max_capacity;
-  static const size_t _large_prime_p;
-  static std::random_device _generator;
-  static std::uniform_int_distribution<size_t> _dist_a;
-  static std::uniform_int_distribution<size_t> _dist_b;
-  static const size_t _rand_a;
-  static const size_t _rand_b;
+  static const size_t _batch_width = 16;
 
   /* Members */
   size_t _size;
   size_t _capacity;
   Node **_table;
+  size_t _old_capacity;
+  Node **_old_table;
+  size_t _migrated;
+  size_t _rehash_step;
+  float _max_load_factor;
+  float _min_load_factor;
+  size_t _filter_bits;
+  BlockedBloomFilter _filter;
+  BlockedBloomFilter _old_filter;
+  Policies _policies;
 
   /* Helpers */
-  size_t hash(const K &);
-  void increase_capacity();
+  NodeAlloc &node_alloc();
+  TableAlloc &table_alloc();
+  template <typename Q>
+  uint64_t hash(const Q &);
+  static size_t bucket(uint64_t, size_t);
+  void migrate(size_t);
+  void advance_rehash();
+  size_t capacity_for(size_t);
+  void resize(size_t);
+  void reset_filter(BlockedBloomFilter &, size_t);
+  void rebuild_filter();
+  BlockedBloomFilter &filter(uint64_t);
+  Node **chain(uint64_t);
+  template <typename Q>
+  Node **find_link(const Q &, uint64_t, size_t &);
+  Node *link_node(Node *, uint64_t);
+  uint64_t node_hash(Node *);
+  template <typename Q>
+  static bool matches(Node *, const Q &, uint64_t);
+  template <typename... Args>
+  Node *create_node(Args &&...);
+  void destroy_node(Node *);
+  Node **create_table(size_t);
+  void destroy_table(Node **, size_t);
+  static void prefetch(const void *);
 
  public:
   /* Constructors */
   HashMap();
+  explicit HashMap(const Alloc &);
+  HashMap(const HashMap &) = delete;
+  HashMap &operator=(const HashMap &) = delete;
   ~HashMap();
 
   /* Util */
@@ -60,29 +200,72 @@ class HashMap {
   size_t size();
   size_t capacity();
   double load_factor();
-  bool has(const K &);
+  template <typename Q = K>
+  bool has(const key_arg<Q> &);
+  bool is_rehashing();
+  void set_rehash_step(size_t);
+  float max_load_factor();
+  void set_max_load_factor(float);
+  float min_load_factor();
+  void set_min_load_factor(float);
+  size_t filter_bits();
+  void set_filter_bits(size_t);
 
   /* Accessors */
-  V &get(const K &);
+  template <typename Q = K>
+  V &get(const key_arg<Q> &);
+  template <typename Q = K>
+  V *find(const key_arg<Q> &);
+  template <typename Q = K>
+  size_t find_batch(const key_arg<Q> *, size_t, V **);
+  template <typename F>
+  void for_each(F &&);
+  Stats &stats();
+  std::vector<size_t> chain_length_histogram();
 
   /* Mutators */
+  void reserve(size_t);
+  void rehash(size_t);
+  void shrink_to_fit();
   void insert(const K &, const V &);
-  void erase(const K &);
+  template <typename RandomIt>
+  void build(RandomIt, RandomIt, size_t = 0);
+  template <typename... Args>
+  std::pair<V *, bool> emplace(Args &&...);
+  template <typename... Args>
+  std::pair<V *, bool> try_emplace(const K &, Args &&...);
+  template <typename... Args>
+  std::pair<V *, bool> try_emplace(K &&, Args &&...);
+  template <typename M>
+  std::pair<V *, bool> insert_or_assign(const K &, M &&);
+  template <typename M>
+  std::pair<V *, bool> insert_or_assign(K &&, M &&);
+  template <typename Q = K>
+  void erase(const key_arg<Q> &);
 };
 
 /**
- * @brief Construct a new Node used for chaining
+ * @brief Construct a new Node used for chaining. The key is built from key and
+ * the value from args, each in place
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam KArg
+ * @tparam Args
  * @param key
- * @param value
+ * @param args
  */
-template <typename K, typename V, typename Hash, typename Pred>
-HashMap<K, V, Hash, Pred>::Node::Node(const K &key, const V &value)
-    : _key(key), _val(value), _next(nullptr) {}
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename KArg, typename... Args>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::Node::Node(KArg &&key, Args &&...args)
+    : _key(std::forward<KArg>(key)),
+      _val(std::forward<Args>(args)...),
+      _next(nullptr) {}
 
 /**
  * @brief Destroy a Node object. Given the tight coupling between HashMap and
@@ -92,184 +275,674 @@ HashMap<K, V, Hash, Pred>::Node::Node(const K &key, const V &value)
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  */
-template <typename K, typename V, typename Hash, typename Pred>
-HashMap<K, V, Hash, Pred>::Node::~Node() {}
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::Node::~Node() {}
 
 /**
- * @brief Cormen[267] states that when designing universal hashing functions, it
- * can be useful to have a prime number larger than any possible hashed key.
- * Therefore, this implementation is arbitrarily limited to 2^32 buckets for the
- * sake of choosing a constant prime
+ * @brief Construct Policies with a fresh seed and default-constructed
+ * allocators and statistics
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  */
-template <typename K, typename V, typename Hash, typename Pred>
-const size_t HashMap<K, V, Hash, Pred>::_max_capacity = 4294967296UL;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::Policies::Policies()
+    : _seed(random_seed()) {}
 
 /**
- * @brief Cormen[267] states that when designing universal hashing functions, it
- * can be useful to have a prime number larger than any possible hashed key. The
- * buckets have been limited to 2^32, and this is the next prime over that value
+ * @brief Construct Policies with a fresh seed and allocators rebound from
+ * alloc
  *
- * In the book, this is 'p'
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param alloc
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::Policies::Policies(const Alloc &alloc)
+    : EmptyBase<NodeAlloc, 0>(NodeAlloc(alloc)),
+      EmptyBase<TableAlloc, 1>(TableAlloc(alloc)),
+      _seed(random_seed()) {}
+
+/**
+ * @brief Returns the allocator for nodes
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return NodeAlloc&
  */
-template <typename K, typename V, typename Hash, typename Pred>
-const size_t HashMap<K, V, Hash, Pred>::_large_prime_p = 4294967311UL;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::NodeAlloc &
+HashMap<K, V, Hash, Pred, Alloc, Stats>::node_alloc() {
+  return _policies.EmptyBase<NodeAlloc, 0>::get();
+}
 
 /**
- * @brief Random number generator for internal use
+ * @brief Returns the allocator for bucket arrays
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return TableAlloc&
  */
-template <typename K, typename V, typename Hash, typename Pred>
-std::random_device HashMap<K, V, Hash, Pred>::_generator;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::TableAlloc &
+HashMap<K, V, Hash, Pred, Alloc, Stats>::table_alloc() {
+  return _policies.EmptyBase<TableAlloc, 1>::get();
+}
 
 /**
- * @brief The random distribution of 'a' in Cormen[267], aka 'Z sub *p'
+ * @brief Hash a key. The functor's output is scrambled with this map's seed, so
+ * the result is safe to mask down to a bucket index, and two maps disagree on
+ * which keys collide.
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash accepts
+ * @param key
+ * @return uint64_t
  */
-template <typename K, typename V, typename Hash, typename Pred>
-std::uniform_int_distribution<size_t> HashMap<K, V, Hash, Pred>::_dist_a(
-    1, _large_prime_p - 1);
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+uint64_t HashMap<K, V, Hash, Pred, Alloc, Stats>::hash(const Q &key) {
+  return mix_hash(Hash()(key), _policies._seed);
+}
 
 /**
- * @brief The random distribution of 'b' in Cormen[267], aka 'Z sub p'
+ * @brief Maps a hashed key to its bucket in a table of the given capacity. The
+ * capacity is always a power of two, so this is a mask rather than a division
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param hashed_key
+ * @param capacity
+ * @return size_t
  */
-template <typename K, typename V, typename Hash, typename Pred>
-std::uniform_int_distribution<size_t> HashMap<K, V, Hash, Pred>::_dist_b(
-    0, _large_prime_p - 1);
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::bucket(uint64_t hashed_key,
+                                                       size_t capacity) {
+  return hashed_key & (capacity - 1);
+}
 
 /**
- * @brief The value of 'a' in Cormen[267]
+ * @brief Allocate and construct a Node with the map's allocator
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Args
+ * @param args forwarded to the Node constructor
+ * @return Node*
  */
-template <typename K, typename V, typename Hash, typename Pred>
-const size_t HashMap<K, V, Hash, Pred>::_rand_a = _dist_a(_generator);
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename... Args>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::Node *
+HashMap<K, V, Hash, Pred, Alloc, Stats>::create_node(Args &&...args) {
+  Node *node = NodeTraits::allocate(node_alloc(), 1);
+  try {
+    NodeTraits::construct(node_alloc(), node, std::forward<Args>(args)...);
+  } catch (...) {
+    NodeTraits::deallocate(node_alloc(), node, 1);
+    throw;
+  }
+  stats().on_allocate(sizeof(Node));
+  return node;
+}
 
 /**
- * @brief The value of 'b' in Cormen[267]
+ * @brief Destroy and deallocate a Node with the map's allocator
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param node
  */
-template <typename K, typename V, typename Hash, typename Pred>
-const size_t HashMap<K, V, Hash, Pred>::_rand_b = _dist_b(_generator);
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::destroy_node(Node *node) {
+  NodeTraits::destroy(node_alloc(), node);
+  NodeTraits::deallocate(node_alloc(), node, 1);
+  stats().on_deallocate(sizeof(Node));
+}
 
 /**
- * @brief The universal hash function from Cormen[267].
+ * @brief Allocate a bucket array of n empty chains
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
- * @param key
- * @return size_t
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n
+ * @return Node**
  */
-template <typename K, typename V, typename Hash, typename Pred>
-size_t HashMap<K, V, Hash, Pred>::hash(const K &key) {
-  size_t hashed_key = (_rand_a * Hash()(key) + _rand_b);
-  hashed_key =
-      hashed_key < _large_prime_p ? hashed_key : hashed_key % _large_prime_p;
-  hashed_key = hashed_key < _capacity ? hashed_key : hashed_key % _capacity;
-  return hashed_key;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::Node **
+HashMap<K, V, Hash, Pred, Alloc, Stats>::create_table(size_t n) {
+  Node **table = TableTraits::allocate(table_alloc(), n);
+  for (size_t i = 0; i < n; i++) table[i] = nullptr;
+  stats().on_allocate(n * sizeof(Node *));
+  return table;
 }
 
 /**
- * @brief Doubles the number of buckets, aka the capacity of the table
+ * @brief Release a bucket array of n chains. The chains must already be empty
+ * or moved elsewhere
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param table
+ * @param n
  */
-template <typename K, typename V, typename Hash, typename Pred>
-void HashMap<K, V, Hash, Pred>::increase_capacity() {
-  size_t old_capacity = _capacity;
-  Node **old_table = _table;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::destroy_table(Node **table,
+                                                            size_t n) {
+  if (!table) return;
+  TableTraits::deallocate(table_alloc(), table, n);
+  stats().on_deallocate(n * sizeof(Node *));
+}
 
-  _capacity = _capacity ? _capacity * 2 : 1;
-  _table = new Node *[_capacity] {};
+/**
+ * @brief Hint that the cache line holding p will be read soon
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param p
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::prefetch(const void *p) {
+#if defined(__GNUC__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
 
-  for (size_t i = 0; i < old_capacity; i++) {
-    Node *node_to_move = old_table[i];
+/**
+ * @brief Moves up to n buckets of the old table into the current one, in
+ * bucket order. Nodes are pushed onto the front of their new chain, so each
+ * move is O(1), and their hashes are added to the new Bloom filter. The old
+ * table and its filter are released once its last bucket is moved
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::migrate(size_t n) {
+  for (; n && _migrated < _old_capacity; n--, _migrated++) {
+    Node *node_to_move = _old_table[_migrated];
     while (node_to_move) {
-      size_t hashed_key = hash(node_to_move->_key);
-
-      if (!_table[hashed_key]) {
-        _table[hashed_key] = node_to_move;
-      } else {
-        Node *curr_node = _table[hashed_key];
-        while (curr_node->_next) curr_node = curr_node->_next;
-        curr_node->_next = node_to_move;
-      }
-
       Node *next_node = node_to_move->_next;
-      node_to_move->_next = nullptr;
+      uint64_t hashed_key = node_hash(node_to_move);
+      size_t index = bucket(hashed_key, _capacity);
+
+      node_to_move->_next = _table[index];
+      _table[index] = node_to_move;
+      _filter.insert(hashed_key);
       node_to_move = next_node;
     }
   }
 
-  delete[] old_table;
+  if (_old_table && _migrated == _old_capacity) {
+    destroy_table(_old_table, _old_capacity);
+    _old_filter.clear();
+    _old_table = nullptr;
+    _old_capacity = 0;
+    _migrated = 0;
+  }
+}
+
+/**
+ * @brief Does one insert or erase's share of an incremental rehash. A table
+ * that has just doubled takes C * max_load_factor more inserts to fill, where C
+ * is the old capacity, and moving the old table takes C / n operations at n
+ * buckets each. Below a load factor of 1 the step is therefore scaled up by
+ * 1 / max_load_factor, so every move finishes before the next growth and no
+ * single insert has to move what is left of the old table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::advance_rehash() {
+  if (!_old_table) return;
+
+  size_t n = _rehash_step;
+  if (_max_load_factor < 1) n = size_t(std::ceil(n / double(_max_load_factor)));
+  migrate(n);
 }
 
 /**
- * @brief Construct a new Hash Map< K,  V,  Hash,  Pred>:: Hash Map object
+ * @brief Returns the smallest power of two number of buckets that holds n
+ * nodes without exceeding the maximum load factor
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n
+ * @return size_t
  */
-template <typename K, typename V, typename Hash, typename Pred>
-HashMap<K, V, Hash, Pred>::HashMap()
-    : _size(0), _capacity(0), _table(nullptr) {}
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::capacity_for(size_t n) {
+  size_t buckets = 1;
+  while (n > buckets * double(_max_load_factor)) buckets *= 2;
+  return buckets;
+}
 
 /**
- * @brief Destroy the Hash Map< K,  V,  Hash,  Pred>:: Hash Map object
+ * @brief Changes the number of buckets, aka the capacity of the table, to
+ * new_capacity, which may be larger or smaller. By default every node is moved
+ * before this returns. If a rehash step is set, the old table is kept, and
+ * each later insert or erase moves that many of its buckets. The old table
+ * keeps its Bloom filter, and the new table's filter starts empty and fills
+ * as nodes move, so the filter never costs a pass over the whole map here
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param new_capacity must be a power of two
  */
-template <typename K, typename V, typename Hash, typename Pred>
-HashMap<K, V, Hash, Pred>::~HashMap() {
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::resize(size_t new_capacity) {
+  stats().on_rehash_begin();
+  if (_old_table) migrate(_old_capacity);
+
+  _old_table = _table;
+  _old_capacity = _capacity;
+  _migrated = 0;
+
+  _capacity = new_capacity;
+  _table = _capacity ? create_table(_capacity) : nullptr;
+
+  std::swap(_filter, _old_filter);
+  reset_filter(_filter, _capacity);
+
+  if (!_rehash_step) migrate(_old_capacity);
+  stats().on_rehash_end();
+}
+
+/**
+ * @brief Empties filter and sizes it for the most nodes a table of capacity
+ * buckets holds before it next grows. With no filter bits set, the filter is
+ * released instead
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param filter
+ * @param capacity
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::reset_filter(
+    BlockedBloomFilter &filter, size_t capacity) {
+  if (!_filter_bits) {
+    filter.clear();
+    return;
+  }
+
+  size_t limit = size_t(capacity * double(_max_load_factor));
+  filter.reset(limit > _size ? limit : _size, _filter_bits);
+}
+
+/**
+ * @brief Resets both Bloom filters and fills them from every node, the new
+ * table's nodes into _filter and the unmoved old ones into _old_filter. This
+ * drops the bits of erased keys
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::rebuild_filter() {
+  reset_filter(_filter, _capacity);
+  for (size_t i = 0; i < _capacity; i++) {
+    for (Node *node = _table[i]; node; node = node->_next)
+      _filter.insert(node_hash(node));
+  }
+
+  if (!_old_table) return;
+
+  reset_filter(_old_filter, _old_capacity);
+  for (size_t i = _migrated; i < _old_capacity; i++) {
+    for (Node *node = _old_table[i]; node; node = node->_next)
+      _old_filter.insert(node_hash(node));
+  }
+}
+
+/**
+ * @brief Returns the Bloom filter that covers hashed_key's chain: the old
+ * table's filter while that chain has not been moved yet, else the current one
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param hashed_key
+ * @return BlockedBloomFilter&
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+BlockedBloomFilter &HashMap<K, V, Hash, Pred, Alloc, Stats>::filter(
+    uint64_t hashed_key) {
+  if (_old_table && bucket(hashed_key, _old_capacity) >= _migrated)
+    return _old_filter;
+  return _filter;
+}
+
+/**
+ * @brief Returns the head of the chain that owns hashed_key. While a rehash is
+ * in progress, a bucket of the old table that has not been moved yet still owns
+ * its keys, including ones inserted since the rehash began
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param hashed_key
+ * @return Node**
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::Node **
+HashMap<K, V, Hash, Pred, Alloc, Stats>::chain(uint64_t hashed_key) {
+  if (_old_table) {
+    size_t old_index = bucket(hashed_key, _old_capacity);
+    if (old_index >= _migrated) return &_old_table[old_index];
+  }
+  return &_table[bucket(hashed_key, _capacity)];
+}
+
+/**
+ * @brief Returns a pointer to the link (a bucket head or a _next field) that
+ * points at key's node, or nullptr if key is absent. probes is set to the
+ * number of nodes compared, which is 0 when the Bloom filter rules key out
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Pred accepts
+ * @param key
+ * @param hashed_key
+ * @param probes
+ * @return Node**
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::Node **
+HashMap<K, V, Hash, Pred, Alloc, Stats>::find_link(const Q &key,
+                                                   uint64_t hashed_key,
+                                                   size_t &probes) {
+  probes = 0;
+  if (!_size || !filter(hashed_key).may_contain(hashed_key)) return nullptr;
+
+  Node **link = chain(hashed_key);
+  while (*link) {
+    probes++;
+    if (matches(*link, key, hashed_key)) return link;
+    link = &(*link)->_next;
+  }
+
+  return nullptr;
+}
+
+/**
+ * @brief Links a new node into the map and returns it. If the node would push
+ * the load factor past its maximum, the table grows first, normally by
+ * doubling. The caller has checked that its key is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param node
+ * @param hashed_key
+ * @return Node*
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+typename HashMap<K, V, Hash, Pred, Alloc, Stats>::Node *
+HashMap<K, V, Hash, Pred, Alloc, Stats>::link_node(Node *node,
+                                                   uint64_t hashed_key) {
+  if (_size + 1 > _capacity * double(_max_load_factor))
+    resize(capacity_for(_size + 1));
+
+  if constexpr (_cache_hash) node->_hash = hashed_key;
+  filter(hashed_key).insert(hashed_key);
+
+  Node **head = chain(hashed_key);
+  node->_next = *head;
+  *head = node;
+  _size++;
+
+  return node;
+}
+
+/**
+ * @brief Returns the hash of a linked node's key, from the node itself if
+ * hashes are cached
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param node
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+uint64_t HashMap<K, V, Hash, Pred, Alloc, Stats>::node_hash(Node *node) {
+  if constexpr (_cache_hash) {
+    return node->_hash;
+  } else {
+    return hash(node->_key);
+  }
+}
+
+/**
+ * @brief Returns true if node holds key. With cached hashes, Pred is only
+ * called when the hashes agree, which rejects nearly every other node in a
+ * chain with one integer compare
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Pred accepts
+ * @param node
+ * @param key
+ * @param hashed_key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+bool HashMap<K, V, Hash, Pred, Alloc, Stats>::matches(Node *node, const Q &key,
+                                                      uint64_t hashed_key) {
+  if constexpr (_cache_hash) {
+    if (node->_hash != hashed_key) return false;
+  } else {
+    (void)hashed_key;
+  }
+  return Pred()(node->_key, key);
+}
+
+/**
+ * @brief Construct a new Hash Map< K,  V,  Hash,  Pred,  Alloc>:: Hash Map
+ * object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::HashMap()
+    : _size(0),
+      _capacity(0),
+      _table(nullptr),
+      _old_capacity(0),
+      _old_table(nullptr),
+      _migrated(0),
+      _rehash_step(0),
+      _max_load_factor(1),
+      _min_load_factor(0),
+      _filter_bits(0) {}
+
+/**
+ * @brief Construct a new Hash Map< K,  V,  Hash,  Pred,  Alloc>:: Hash Map
+ * object whose nodes and buckets come from alloc
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param alloc
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::HashMap(const Alloc &alloc)
+    : _size(0),
+      _capacity(0),
+      _table(nullptr),
+      _old_capacity(0),
+      _old_table(nullptr),
+      _migrated(0),
+      _rehash_step(0),
+      _max_load_factor(1),
+      _min_load_factor(0),
+      _filter_bits(0),
+      _policies(alloc) {}
+
+/**
+ * @brief Destroy the Hash Map< K,  V,  Hash,  Pred,  Alloc>:: Hash Map object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::~HashMap() {
   for (size_t i = 0; i < _capacity; i++) {
     Node *curr_node = _table[i];
     while (curr_node) {
       Node *next_node = curr_node->_next;
-      delete curr_node;
+      destroy_node(curr_node);
       curr_node = next_node;
     }
   }
-  delete[] _table;
+  destroy_table(_table, _capacity);
+
+  for (size_t i = _migrated; i < _old_capacity; i++) {
+    Node *curr_node = _old_table[i];
+    while (curr_node) {
+      Node *next_node = curr_node->_next;
+      destroy_node(curr_node);
+      curr_node = next_node;
+    }
+  }
+  destroy_table(_old_table, _old_capacity);
 }
 
 /**
@@ -279,10 +952,13 @@ HashMap<K, V, Hash, Pred>::~HashMap() {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  * @return boolean
  */
-template <typename K, typename V, typename Hash, typename Pred>
-bool HashMap<K, V, Hash, Pred>::is_empty() {
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+bool HashMap<K, V, Hash, Pred, Alloc, Stats>::is_empty() {
   return !_size;
 }
 
@@ -293,25 +969,32 @@ bool HashMap<K, V, Hash, Pred>::is_empty() {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  * @return size_t
  */
-template <typename K, typename V, typename Hash, typename Pred>
-size_t HashMap<K, V, Hash, Pred>::size() {
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::size() {
   return _size;
 }
 
 /**
- * @brief Returns the current number of buckets, which is also the number of
- * nodes that can be stored before the HashMap must resize
+ * @brief Returns the current number of buckets. With the default maximum load
+ * factor of 1 this is also the number of nodes that can be stored before the
+ * HashMap must resize
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  * @return size_t
  */
-template <typename K, typename V, typename Hash, typename Pred>
-size_t HashMap<K, V, Hash, Pred>::capacity() {
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::capacity() {
   return _capacity;
 }
 
@@ -322,10 +1005,13 @@ size_t HashMap<K, V, Hash, Pred>::capacity() {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  * @return double
  */
-template <typename K, typename V, typename Hash, typename Pred>
-double HashMap<K, V, Hash, Pred>::load_factor() {
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+double HashMap<K, V, Hash, Pred, Alloc, Stats>::load_factor() {
   return double(_size) / double(_capacity);
 }
 
@@ -336,21 +1022,190 @@ double HashMap<K, V, Hash, Pred>::load_factor() {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash and Pred accept
  * @param key
  * @return boolean
  */
-template <typename K, typename V, typename Hash, typename Pred>
-bool HashMap<K, V, Hash, Pred>::has(const K &key) {
-  if (!_size) return false;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+bool HashMap<K, V, Hash, Pred, Alloc, Stats>::has(const key_arg<Q> &key) {
+  size_t probes;
+  Node **link = find_link(key, hash(key), probes);
+  stats().on_lookup(probes);
+  return link;
+}
 
-  Node *curr_node = _table[hash(key)];
+/**
+ * @brief Returns true while an incremental rehash is moving nodes out of the
+ * previous table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+bool HashMap<K, V, Hash, Pred, Alloc, Stats>::is_rehashing() {
+  return _old_table;
+}
+
+/**
+ * @brief Bound the work done by any single insert or erase. With a step of n,
+ * growing the table only allocates the new bucket array, and each later insert
+ * or erase moves n buckets of the old one, or n / max_load_factor when the
+ * maximum load factor is below 1. Lookups search both tables until the move
+ * completes. A step of 0 (the default) rehashes all at once. With that scaling,
+ * any step >= 1 finishes a move before the table next grows
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n buckets moved per insert or erase
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::set_rehash_step(size_t n) {
+  _rehash_step = n;
+  if (!_rehash_step) migrate(_old_capacity);
+}
 
-  while (curr_node) {
-    if (curr_node->_key == key) return true;
-    curr_node = curr_node->_next;
+/**
+ * @brief Returns the load factor past which an insert grows the table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return float
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+float HashMap<K, V, Hash, Pred, Alloc, Stats>::max_load_factor() {
+  return _max_load_factor;
+}
+
+/**
+ * @brief Set the load factor past which an insert grows the table. The
+ * default of 1 allows one node per bucket on average. Lower values trade
+ * memory for shorter chains. If the map is already over the new limit, it
+ * grows now. Throws std::invalid_argument unless f is positive and at least
+ * twice the minimum load factor
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param f
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::set_max_load_factor(float f) {
+  if (!(f > 0) || _min_load_factor * 2 > f)
+    throw std::invalid_argument("max load factor");
+
+  _max_load_factor = f;
+  if (_size > _capacity * double(_max_load_factor)) {
+    rehash(_capacity);
+  } else {
+    rebuild_filter();
   }
+}
 
-  return false;
+/**
+ * @brief Returns the load factor below which an erase shrinks the table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return float
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+float HashMap<K, V, Hash, Pred, Alloc, Stats>::min_load_factor() {
+  return _min_load_factor;
+}
+
+/**
+ * @brief Set the load factor below which an erase shrinks the table. The
+ * default of 0 never shrinks. A shrink picks the smallest capacity that holds
+ * twice the remaining entries within the maximum load factor, so the map can
+ * double again before it grows, and alternating inserts and erases at the
+ * threshold do not rehash each time. f may be at most half the maximum load
+ * factor. Throws std::invalid_argument otherwise
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param f
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::set_min_load_factor(float f) {
+  if (!(f >= 0) || f * 2 > _max_load_factor)
+    throw std::invalid_argument("min load factor");
+
+  _min_load_factor = f;
+}
+
+/**
+ * @brief Returns the Bloom filter bits per key, or 0 if the filter is off
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::filter_bits() {
+  return _filter_bits;
+}
+
+/**
+ * @brief Put a blocked Bloom filter (see BloomFilter.h) in front of the table,
+ * with n bits per key, or remove it with n = 0 (the default). Lookups and
+ * inserts of a key the filter rules out skip the chain walk, which pays off
+ * when most lookups miss. 10 bits per key passes about 1% of misses, and costs
+ * 1.25 bytes per bucket at a load factor of 1. A resized table starts a fresh
+ * filter that fills as nodes move into it, so keys erased before the last
+ * resize no longer pass it, but later ones can
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n bits per key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::set_filter_bits(size_t n) {
+  _filter_bits = n;
+  rebuild_filter();
 }
 
 /**
@@ -360,21 +1215,259 @@ bool HashMap<K, V, Hash, Pred>::has(const K &key) {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash and Pred accept
  * @param key
  * @return V&
  */
-template <typename K, typename V, typename Hash, typename Pred>
-V &HashMap<K, V, Hash, Pred>::get(const K &key) {
-  if (!_size) throw std::out_of_range("key not found");
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+V &HashMap<K, V, Hash, Pred, Alloc, Stats>::get(const key_arg<Q> &key) {
+  size_t probes;
+  Node **link = find_link(key, hash(key), probes);
+  stats().on_lookup(probes);
+  if (!link) throw std::out_of_range("key not found");
+  return (*link)->_val;
+}
+
+/**
+ * @brief Returns a pointer to the value associated with the provided key, or
+ * nullptr if it is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash and Pred accept
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+V *HashMap<K, V, Hash, Pred, Alloc, Stats>::find(const key_arg<Q> &key) {
+  size_t probes;
+  Node **link = find_link(key, hash(key), probes);
+  stats().on_lookup(probes);
+  return link ? &(*link)->_val : nullptr;
+}
+
+/**
+ * @brief Look up n keys at once. values[i] is set to the address of keys[i]'s
+ * value, or nullptr if it is absent. Keys are processed in groups of 16 in
+ * three passes. The first pass hashes each key and, unless the Bloom filter
+ * rules it out, prefetches its bucket. The second prefetches the head node of
+ * each chain. The third walks the chains. This way the cache misses of a whole
+ * group overlap instead of being paid one after another
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash and Pred accept
+ * @param keys
+ * @param n
+ * @param values an array of n pointers to fill
+ * @return size_t the number of keys found
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+size_t HashMap<K, V, Hash, Pred, Alloc, Stats>::find_batch(
+    const key_arg<Q> *keys, size_t n, V **values) {
+  size_t found = 0;
+  uint64_t hashed_keys[_batch_width];
+  Node **chains[_batch_width];
+
+  for (size_t base = 0; base < n; base += _batch_width) {
+    size_t width = n - base < _batch_width ? n - base : _batch_width;
+
+    if (!_size) {
+      for (size_t i = 0; i < width; i++) {
+        values[base + i] = nullptr;
+        stats().on_lookup(0);
+      }
+      continue;
+    }
 
-  Node *curr_node = _table[hash(key)];
+    for (size_t i = 0; i < width; i++) {
+      hashed_keys[i] = hash(keys[base + i]);
+      if (!filter(hashed_keys[i]).may_contain(hashed_keys[i])) {
+        chains[i] = nullptr;
+        continue;
+      }
+      chains[i] = chain(hashed_keys[i]);
+      prefetch(chains[i]);
+    }
+
+    for (size_t i = 0; i < width; i++) {
+      if (chains[i] && *chains[i]) prefetch(*chains[i]);
+    }
 
-  while (curr_node) {
-    if (curr_node->_key == key) return curr_node->_val;
-    curr_node = curr_node->_next;
+    for (size_t i = 0; i < width; i++) {
+      Node *curr_node = chains[i] ? *chains[i] : nullptr;
+      size_t probes = curr_node != nullptr;
+      while (curr_node &&
+             !matches(curr_node, keys[base + i], hashed_keys[i])) {
+        curr_node = curr_node->_next;
+        probes += curr_node != nullptr;
+      }
+      stats().on_lookup(probes);
+
+      values[base + i] = curr_node ? &curr_node->_val : nullptr;
+      found += curr_node != nullptr;
+    }
   }
 
-  throw std::out_of_range("key not found");
+  return found;
+}
+
+/**
+ * @brief Calls visit(key, value) once for every entry, in no particular order.
+ * visit must not insert into or erase from the HashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam F callable as void(const K &, V &)
+ * @param visit
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename F>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::for_each(F &&visit) {
+  for (size_t i = 0; i < _capacity; i++) {
+    for (Node *node = _table[i]; node; node = node->_next)
+      visit(node->_key, node->_val);
+  }
+
+  for (size_t i = _migrated; i < _old_capacity; i++) {
+    for (Node *node = _old_table[i]; node; node = node->_next)
+      visit(node->_key, node->_val);
+  }
+}
+
+/**
+ * @brief Returns the statistics policy. With the default NoHashMapStats it
+ * records nothing. Use HashMapStats to collect probe counts, resize timings and
+ * allocation totals
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return Stats&
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+Stats &HashMap<K, V, Hash, Pred, Alloc, Stats>::stats() {
+  return _policies.EmptyBase<Stats, 2>::get();
+}
+
+/**
+ * @brief Returns how many buckets hold chains of each length, so that
+ * histogram[n] buckets have n nodes. A good Hash at load factor a gives
+ * roughly a Poisson distribution with mean a. This walks every chain, so it
+ * is meant for periodic sampling, not the hot path
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @return std::vector<size_t>
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+std::vector<size_t>
+HashMap<K, V, Hash, Pred, Alloc, Stats>::chain_length_histogram() {
+  std::vector<size_t> histogram;
+
+  auto count = [&](Node *node) {
+    size_t length = 0;
+    for (; node; node = node->_next) length++;
+    if (length >= histogram.size()) histogram.resize(length + 1, 0);
+    histogram[length]++;
+  };
+
+  for (size_t i = 0; i < _capacity; i++) count(_table[i]);
+  for (size_t i = _migrated; i < _old_capacity; i++) count(_old_table[i]);
+
+  return histogram;
+}
+
+/**
+ * @brief Make room for n nodes without exceeding the maximum load factor, so
+ * that inserting up to n keys causes no further resize. Never shrinks the
+ * table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param n
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::reserve(size_t n) {
+  size_t buckets = capacity_for(n);
+  if (buckets > _capacity) rehash(buckets);
+}
+
+/**
+ * @brief Rebuild the table with at least the given number of buckets, and at
+ * least enough for the current size under the maximum load factor, rounded
+ * up to a power of two. This can shrink the table. Unlike automatic growth,
+ * it finishes before returning, even if a rehash step is set
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param buckets
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::rehash(size_t buckets) {
+  size_t target = _size || buckets ? capacity_for(_size) : 0;
+  while (target < buckets) target *= 2;
+
+  if (target != _capacity) resize(target);
+  migrate(_old_capacity);
+}
+
+/**
+ * @brief Shrink the table to the smallest capacity that holds the current
+ * size under the maximum load factor. An empty map releases its buckets
+ * entirely
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::shrink_to_fit() {
+  rehash(0);
 }
 
 /**
@@ -384,63 +1477,350 @@ V &HashMap<K, V, Hash, Pred>::get(const K &key) {
  * @tparam V
  * @tparam Hash
  * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
  * @param key
  * @param value
  */
-template <typename K, typename V, typename Hash, typename Pred>
-void HashMap<K, V, Hash, Pred>::insert(const K &key, const V &value) {
-  if (_size == _capacity) increase_capacity();
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::insert(const K &key,
+                                                     const V &value) {
+  insert_or_assign(key, value);
+}
 
-  size_t hashed_key = hash(key);
+/**
+ * @brief Insert or overwrite every pair in [first, last), splitting the work
+ * across threads. The table is sized for all of the pairs up front, so nothing
+ * is rehashed along the way. Then:
+ *
+ * - each thread hashes a slice of the pairs and counts them per partition,
+ *   where a partition is a contiguous range of buckets
+ * - each thread scatters its slice's positions into a partition-ordered array
+ * - each thread links the pairs of whole partitions into their buckets. No two
+ *   threads touch the same bucket, so no locks are needed
+ *
+ * Partitions keep input order, so the last of several equal keys wins, as
+ * with repeated inserts. Nodes are created by the linking threads only if the
+ * allocator is stateless (always equal), like std::allocator. Otherwise, as
+ * with SlabAllocator, a single thread links every partition. Hash, Pred and
+ * the copy constructors of K and V must be safe to call from several threads.
+ * If one of them throws, the pairs linked so far stay in the map and the
+ * exception is rethrown. Stats sees the allocations but no per-key insert
+ * events
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam RandomIt random access iterator to pairs with first and second
+ * members
+ * @param first
+ * @param last
+ * @param threads the most threads to use, or 0 for one per core
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename RandomIt>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::build(RandomIt first,
+                                                    RandomIt last,
+                                                    size_t threads) {
+  size_t n = last - first;
+  if (!n) return;
 
-  if (!_table[hashed_key]) {
-    _table[hashed_key] = new Node(key, value);
-    _size++;
-  } else {
-    Node *curr_node = _table[hashed_key];
+  if (!threads) threads = std::max(1U, std::thread::hardware_concurrency());
+  threads = std::min(threads, n);
+  size_t linkers = NodeTraits::is_always_equal::value ? threads : 1;
+
+  migrate(_old_capacity);
+  reserve(_size + n);
+  migrate(_old_capacity);
 
-    while (curr_node->_key != key && curr_node->_next)
-      curr_node = curr_node->_next;
+  // enough partitions that linkers finishing early can be handed more
+  size_t partitions = 1;
+  while (partitions < threads * 8 && partitions < _capacity) partitions *= 2;
+  size_t shift = 0;
+  while ((partitions << shift) < _capacity) shift++;
 
-    if (curr_node->_key == key) {
-      curr_node->_val = value;
-    } else {
-      curr_node->_next = new Node(key, value);
-      _size++;
+  std::vector<uint64_t> hashed_keys(n);
+  std::vector<size_t> offsets(threads * partitions, 0);
+  std::vector<size_t> starts(partitions + 1, 0);
+  std::vector<size_t> order(n);
+  std::vector<size_t> created(linkers, 0);
+  std::vector<std::exception_ptr> errors(threads);
+
+  auto run = [&](size_t workers, auto &&work) {
+    auto guarded = [&](size_t t) {
+      try {
+        work(t);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < workers; t++) pool.emplace_back(guarded, t);
+    guarded(0);
+    for (std::thread &thread : pool) thread.join();
+  };
+
+  auto rethrow = [&]() {
+    for (std::exception_ptr &error : errors) {
+      if (error) std::rethrow_exception(error);
     }
+  };
+
+  run(threads, [&](size_t t) {
+    size_t *counts = &offsets[t * partitions];
+    for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) {
+      hashed_keys[i] = hash(first[i].first);
+      counts[bucket(hashed_keys[i], _capacity) >> shift]++;
+    }
+  });
+  rethrow();
+
+  // turn the counts into each slice's first position in each partition
+  size_t position = 0;
+  for (size_t p = 0; p < partitions; p++) {
+    starts[p] = position;
+    for (size_t t = 0; t < threads; t++) {
+      size_t count = offsets[t * partitions + p];
+      offsets[t * partitions + p] = position;
+      position += count;
+    }
+  }
+  starts[partitions] = n;
+
+  run(threads, [&](size_t t) {
+    size_t *next = &offsets[t * partitions];
+    for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++)
+      order[next[bucket(hashed_keys[i], _capacity) >> shift]++] = i;
+  });
+  rethrow();
+
+  run(linkers, [&](size_t t) {
+    NodeAlloc alloc(node_alloc());
+
+    for (size_t p = t; p < partitions; p += linkers) {
+      for (size_t j = starts[p]; j < starts[p + 1]; j++) {
+        size_t i = order[j];
+        uint64_t hashed_key = hashed_keys[i];
+        Node **head = &_table[bucket(hashed_key, _capacity)];
+
+        Node **link = head;
+        while (*link && !matches(*link, first[i].first, hashed_key))
+          link = &(*link)->_next;
+        if (*link) {
+          (*link)->_val = first[i].second;
+          continue;
+        }
+
+        Node *node = NodeTraits::allocate(alloc, 1);
+        try {
+          NodeTraits::construct(alloc, node, first[i].first, first[i].second);
+        } catch (...) {
+          NodeTraits::deallocate(alloc, node, 1);
+          throw;
+        }
+
+        if constexpr (_cache_hash) node->_hash = hashed_key;
+        node->_next = *head;
+        *head = node;
+        created[t]++;
+      }
+    }
+  });
+
+  for (size_t count : created) {
+    _size += count;
+    stats().on_allocate(count * sizeof(Node));
   }
+  for (size_t i = 0; i < n; i++) _filter.insert(hashed_keys[i]);
+  rethrow();
 }
 
 /**
- * @brief Delete a key/value pair
+ * @brief Build a node from args as if by Node(args...), then keep it only if
+ * its key is absent. Like std::unordered_map::emplace, this pays for a node
+ * even when the key exists. Prefer try_emplace when the key is at hand
  *
  * @tparam K
  * @tparam V
  * @tparam Hash
  * @tparam Pred
- * @param key
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Args
+ * @param args a key argument followed by value constructor arguments
+ * @return std::pair<V *, bool> the key's value, and whether it was inserted
  */
-template <typename K, typename V, typename Hash, typename Pred>
-void HashMap<K, V, Hash, Pred>::erase(const K &key) {
-  if (!_size) return;
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename... Args>
+std::pair<V *, bool> HashMap<K, V, Hash, Pred, Alloc, Stats>::emplace(
+    Args &&...args) {
+  advance_rehash();
 
-  size_t hashed_key = hash(key);
-  Node *curr_node = _table[hashed_key];
-  Node *prev_node = nullptr;
+  Node *new_node = create_node(std::forward<Args>(args)...);
+  uint64_t hashed_key = hash(new_node->_key);
 
-  while (curr_node && curr_node->_key != key) {
-    prev_node = curr_node;
-    curr_node = curr_node->_next;
+  size_t probes;
+  Node **link = find_link(new_node->_key, hashed_key, probes);
+  stats().on_insert(probes);
+  if (link) {
+    destroy_node(new_node);
+    return std::pair<V *, bool>(&(*link)->_val, false);
   }
 
-  if (curr_node) {
-    if (!prev_node) {
-      _table[hashed_key] = curr_node->_next;
-    } else {
-      prev_node->_next = curr_node->_next;
-    }
+  return std::pair<V *, bool>(&link_node(new_node, hashed_key)->_val, true);
+}
+
+/**
+ * @brief Insert key with a value constructed in place from args, unless key is
+ * present, in which case nothing is constructed and args are left untouched
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Args
+ * @param key
+ * @param args
+ * @return std::pair<V *, bool> the key's value, and whether it was inserted
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename... Args>
+std::pair<V *, bool> HashMap<K, V, Hash, Pred, Alloc, Stats>::try_emplace(
+    const K &key, Args &&...args) {
+  advance_rehash();
+
+  uint64_t hashed_key = hash(key);
+  size_t probes;
+  Node **link = find_link(key, hashed_key, probes);
+  stats().on_insert(probes);
+  if (link) return std::pair<V *, bool>(&(*link)->_val, false);
+
+  Node *new_node = create_node(key, std::forward<Args>(args)...);
+  return std::pair<V *, bool>(&link_node(new_node, hashed_key)->_val, true);
+}
+
+/**
+ * @brief Insert key, moved into the map, with a value constructed in place
+ * from args, unless key is present. In that case key is not moved from
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Args
+ * @param key
+ * @param args
+ * @return std::pair<V *, bool> the key's value, and whether it was inserted
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename... Args>
+std::pair<V *, bool> HashMap<K, V, Hash, Pred, Alloc, Stats>::try_emplace(
+    K &&key, Args &&...args) {
+  advance_rehash();
+
+  uint64_t hashed_key = hash(key);
+  size_t probes;
+  Node **link = find_link(key, hashed_key, probes);
+  stats().on_insert(probes);
+  if (link) return std::pair<V *, bool>(&(*link)->_val, false);
+
+  Node *new_node = create_node(std::move(key), std::forward<Args>(args)...);
+  return std::pair<V *, bool>(&link_node(new_node, hashed_key)->_val, true);
+}
+
+/**
+ * @brief Assign value to key's entry if present, otherwise insert it
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam M a type assignable and convertible to V
+ * @param key
+ * @param value
+ * @return std::pair<V *, bool> the key's value, and whether it was inserted
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename M>
+std::pair<V *, bool> HashMap<K, V, Hash, Pred, Alloc, Stats>::insert_or_assign(
+    const K &key, M &&value) {
+  std::pair<V *, bool> result = try_emplace(key, std::forward<M>(value));
+  if (!result.second) *result.first = std::forward<M>(value);
+  return result;
+}
+
+/**
+ * @brief Assign value to key's entry if present, otherwise move key into the
+ * map and insert it
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam M a type assignable and convertible to V
+ * @param key
+ * @param value
+ * @return std::pair<V *, bool> the key's value, and whether it was inserted
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename M>
+std::pair<V *, bool> HashMap<K, V, Hash, Pred, Alloc, Stats>::insert_or_assign(
+    K &&key, M &&value) {
+  std::pair<V *, bool> result =
+      try_emplace(std::move(key), std::forward<M>(value));
+  if (!result.second) *result.first = std::forward<M>(value);
+  return result;
+}
+
+/**
+ * @brief Delete a key/value pair. If a minimum load factor is set and the map
+ * drops below it, the table shrinks
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @tparam Q K, or any type the transparent Hash and Pred accept
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Alloc, typename Stats>
+template <typename Q>
+void HashMap<K, V, Hash, Pred, Alloc, Stats>::erase(const key_arg<Q> &key) {
+  advance_rehash();
+
+  size_t probes;
+  Node **link = find_link(key, hash(key), probes);
+  if (!link) return;
+
+  Node *curr_node = *link;
+  *link = curr_node->_next;
+  destroy_node(curr_node);
+  _size--;
 
-    delete curr_node;
-    _size--;
+  if (_size < _capacity * double(_min_load_factor)) {
+    size_t buckets = capacity_for(2 * _size);
+    if (buckets < _capacity) resize(buckets);
   }
 }
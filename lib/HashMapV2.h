@@ -0,0 +1,535 @@
+/**
+ * @file HashMapV2.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief An open-addressing HashMap modeled on Abseil's "Swiss tables".
+ * Entries are stored in one flat slot array. A separate array holds one control
+ * byte per slot: empty, deleted, or the low 7 bits of the slot's hash. Lookups
+ * probe 16 control bytes at a time (with SSE2 when it is available, otherwise
+ * with a scalar loop). The slot array is only read for likely matches, so a
+ * lookup usually costs one control-byte cache line and one slot cache line.
+ *
+ * The public interface mirrors HashMapV1.h so the two can be swapped.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Hashing.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class HashMapV2 {
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    K _key;
+    V _val;
+
+    Slot(const K &, const V &);
+    Slot(Slot &&);
+  };
+
+  class Group {
+   public:
+    Group(const int8_t *);
+
+    uint32_t match(int8_t) const;
+    uint32_t match_empty() const;
+    uint32_t match_empty_or_deleted() const;
+
+   private:
+#if defined(__SSE2__)
+    __m128i _ctrl;
+#else
+    int8_t _ctrl[16];
+#endif
+  };
+
+  /* Static Members */
+  static const size_t _group_width = 16;
+  static const int8_t _empty = -128;
+  static const int8_t _deleted = -2;
+
+  /* Members */
+  size_t _size;
+  size_t _capacity;
+  size_t _growth_left;
+  int8_t *_ctrl;
+  Slot *_slots;
+  uint64_t _seed;
+
+  /* Helpers */
+  uint64_t hash(const K &);
+  size_t find(const K &, uint64_t);
+  size_t find_insert_slot(uint64_t);
+  void resize(size_t);
+  static size_t next_bit(uint32_t &);
+
+ public:
+  /* Constructors */
+  HashMapV2();
+  HashMapV2(const HashMapV2 &) = delete;
+  HashMapV2 &operator=(const HashMapV2 &) = delete;
+  ~HashMapV2();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t capacity();
+  double load_factor();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Construct a new Slot in place
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+HashMapV2<K, V, Hash, Pred>::Slot::Slot(const K &key, const V &value)
+    : _key(key), _val(value) {}
+
+/**
+ * @brief Move a Slot into new storage during a resize
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param other
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+HashMapV2<K, V, Hash, Pred>::Slot::Slot(Slot &&other)
+    : _key(std::move(other._key)), _val(std::move(other._val)) {}
+
+/**
+ * @brief Load the 16 control bytes starting at ctrl
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param ctrl
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+HashMapV2<K, V, Hash, Pred>::Group::Group(const int8_t *ctrl) {
+#if defined(__SSE2__)
+  _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+  for (size_t i = 0; i < _group_width; i++) _ctrl[i] = ctrl[i];
+#endif
+}
+
+/**
+ * @brief Returns a bitmask with bit i set if control byte i equals h2
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param h2
+ * @return uint32_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+uint32_t HashMapV2<K, V, Hash, Pred>::Group::match(int8_t h2) const {
+#if defined(__SSE2__)
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < _group_width; i++)
+    if (_ctrl[i] == h2) mask |= 1U << i;
+  return mask;
+#endif
+}
+
+/**
+ * @brief Returns a bitmask with bit i set if slot i is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return uint32_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+uint32_t HashMapV2<K, V, Hash, Pred>::Group::match_empty() const {
+  return match(_empty);
+}
+
+/**
+ * @brief Returns a bitmask with bit i set if slot i is empty or deleted. Both
+ * are negative, while full slots hold a 7 bit hash, so this is a signed compare
+ * against -1
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return uint32_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+uint32_t HashMapV2<K, V, Hash, Pred>::Group::match_empty_or_deleted() const {
+#if defined(__SSE2__)
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < _group_width; i++)
+    if (_ctrl[i] < -1) mask |= 1U << i;
+  return mask;
+#endif
+}
+
+/**
+ * @brief Hash a key. The high 57 bits (h1) choose where probing starts, and the
+ * low 7 bits (h2) are stored in the control byte
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+uint64_t HashMapV2<K, V, Hash, Pred>::hash(const K &key) {
+  return mix_hash(Hash()(key), _seed);
+}
+
+/**
+ * @brief Returns the slot index holding key, or _capacity if it is absent.
+ * Groups are probed in triangular order (g, g+1, g+3, g+6, ...), which visits
+ * every group when the group count is a power of two. The search stops at the
+ * first group that has an empty slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param hashed_key
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t HashMapV2<K, V, Hash, Pred>::find(const K &key, uint64_t hashed_key) {
+  if (!_size) return _capacity;
+
+  size_t group_mask = _capacity / _group_width - 1;
+  size_t group = (hashed_key >> 7) & group_mask;
+  int8_t h2 = hashed_key & 0x7F;
+
+  for (size_t i = 1;; i++) {
+    size_t offset = group * _group_width;
+    Group g(_ctrl + offset);
+
+    uint32_t matches = g.match(h2);
+    while (matches) {
+      size_t index = offset + next_bit(matches);
+      if (Pred()(_slots[index]._key, key)) return index;
+    }
+
+    if (g.match_empty()) return _capacity;
+    group = (group + i) & group_mask;
+  }
+}
+
+/**
+ * @brief Returns the first empty or deleted slot along the probe sequence of
+ * hashed_key. The caller guarantees there is room
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param hashed_key
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t HashMapV2<K, V, Hash, Pred>::find_insert_slot(uint64_t hashed_key) {
+  size_t group_mask = _capacity / _group_width - 1;
+  size_t group = (hashed_key >> 7) & group_mask;
+
+  for (size_t i = 1;; i++) {
+    size_t offset = group * _group_width;
+    uint32_t available = Group(_ctrl + offset).match_empty_or_deleted();
+    if (available) return offset + next_bit(available);
+    group = (group + i) & group_mask;
+  }
+}
+
+/**
+ * @brief Moves every entry into a fresh table of new_capacity slots. This also
+ * drops all deleted markers
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param new_capacity must be a power of two and a multiple of 16
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void HashMapV2<K, V, Hash, Pred>::resize(size_t new_capacity) {
+  size_t old_capacity = _capacity;
+  int8_t *old_ctrl = _ctrl;
+  Slot *old_slots = _slots;
+
+  _capacity = new_capacity;
+  _growth_left = _capacity - _capacity / 8 - _size;
+  _ctrl = new int8_t[_capacity];
+  _slots = static_cast<Slot *>(::operator new(_capacity * sizeof(Slot)));
+  for (size_t i = 0; i < _capacity; i++) _ctrl[i] = _empty;
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old_ctrl[i] < 0) continue;
+
+    uint64_t hashed_key = hash(old_slots[i]._key);
+    size_t index = find_insert_slot(hashed_key);
+
+    _ctrl[index] = hashed_key & 0x7F;
+    new (&_slots[index]) Slot(std::move(old_slots[i]));
+    old_slots[i].~Slot();
+  }
+
+  delete[] old_ctrl;
+  ::operator delete(old_slots);
+}
+
+/**
+ * @brief Returns the index of the lowest set bit of mask, and clears it
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param mask must be non-zero
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t HashMapV2<K, V, Hash, Pred>::next_bit(uint32_t &mask) {
+#if defined(__GNUC__)
+  size_t index = __builtin_ctz(mask);
+#else
+  size_t index = 0;
+  while (!(mask & (1U << index))) index++;
+#endif
+  mask &= mask - 1;
+  return index;
+}
+
+/**
+ * @brief Construct a new HashMapV2 object. No storage is allocated until the
+ * first insert
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+HashMapV2<K, V, Hash, Pred>::HashMapV2()
+    : _size(0),
+      _capacity(0),
+      _growth_left(0),
+      _ctrl(nullptr),
+      _slots(nullptr),
+      _seed(random_seed()) {}
+
+/**
+ * @brief Destroy the HashMapV2 object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+HashMapV2<K, V, Hash, Pred>::~HashMapV2() {
+  for (size_t i = 0; i < _capacity; i++) {
+    if (_ctrl[i] >= 0) _slots[i].~Slot();
+  }
+  delete[] _ctrl;
+  ::operator delete(_slots);
+}
+
+/**
+ * @brief Returns true if HashMapV2 is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool HashMapV2<K, V, Hash, Pred>::is_empty() {
+  return !_size;
+}
+
+/**
+ * @brief Returns the number of entries stored in the HashMapV2
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t HashMapV2<K, V, Hash, Pred>::size() {
+  return _size;
+}
+
+/**
+ * @brief Returns the current number of slots. The table resizes once 7/8 of
+ * them are used
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t HashMapV2<K, V, Hash, Pred>::capacity() {
+  return _capacity;
+}
+
+/**
+ * @brief Returns the ratio of size / capacity
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+double HashMapV2<K, V, Hash, Pred>::load_factor() {
+  return double(_size) / double(_capacity);
+}
+
+/**
+ * @brief Returns true if HashMapV2 contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool HashMapV2<K, V, Hash, Pred>::has(const K &key) {
+  return find(key, hash(key)) != _capacity;
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V &HashMapV2<K, V, Hash, Pred>::get(const K &key) {
+  size_t index = find(key, hash(key));
+  if (index == _capacity) throw std::out_of_range("key not found");
+  return _slots[index]._val;
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair. Reusing a deleted slot does not
+ * count against the growth budget. When the budget runs out the table doubles,
+ * unless at least half of the budget was spent on deleted slots. In that case
+ * it is rebuilt at the same capacity to clear them
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void HashMapV2<K, V, Hash, Pred>::insert(const K &key, const V &value) {
+  uint64_t hashed_key = hash(key);
+
+  size_t index = find(key, hashed_key);
+  if (index != _capacity) {
+    _slots[index]._val = value;
+    return;
+  }
+
+  if (!_capacity) resize(_group_width);
+
+  index = find_insert_slot(hashed_key);
+  if (!_growth_left && _ctrl[index] != _deleted) {
+    size_t max_size = _capacity - _capacity / 8;
+    resize(_size * 2 < max_size ? _capacity : _capacity * 2);
+    index = find_insert_slot(hashed_key);
+  }
+
+  if (_ctrl[index] == _empty) _growth_left--;
+  new (&_slots[index]) Slot(key, value);
+  _ctrl[index] = hashed_key & 0x7F;
+  _size++;
+}
+
+/**
+ * @brief Delete a key/value pair. If the slot's group still has an empty slot,
+ * then no probe sequence has ever passed through this group. In that case the
+ * slot can be marked empty again. Otherwise it must be marked deleted so that
+ * lookups keep probing past it
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void HashMapV2<K, V, Hash, Pred>::erase(const K &key) {
+  size_t index = find(key, hash(key));
+  if (index == _capacity) return;
+
+  _slots[index].~Slot();
+  _size--;
+
+  size_t offset = index - index % _group_width;
+  if (Group(_ctrl + offset).match_empty()) {
+    _ctrl[index] = _empty;
+    _growth_left++;
+  } else {
+    _ctrl[index] = _deleted;
+  }
+}
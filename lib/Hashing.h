@@ -0,0 +1,57 @@
+/**
+ * @file Hashing.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief Hashing helpers shared by the hash tables in this library. The
+ * std::hash functors are allowed to be very weak (libstdc++ hashes integers to
+ * themselves), so every table runs the functor's output through mix_hash()
+ * before using any of its bits.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+/**
+ * @brief Scrambles a hash value with a seed. This is the 64-bit finalizer from
+ * MurmurHash3: two multiply-xorshift rounds, after which every output bit
+ * depends on every input bit. Because of this, callers can take the low bits as
+ * a bucket index with a mask instead of reducing with %.
+ *
+ * @param key the output of a Hash functor
+ * @param seed a per-table random value
+ * @return uint64_t
+ */
+inline uint64_t mix_hash(uint64_t key, uint64_t seed) {
+  uint64_t x = key ^ seed;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/**
+ * @brief Returns a fresh seed for a hash table instance. A single
+ * std::random_device read seeds the process, and each call mixes a counter
+ * into it, so constructing many tables never touches the entropy source again.
+ *
+ * @return uint64_t
+ */
+inline uint64_t random_seed() {
+  static const uint64_t process_seed = []() {
+    std::random_device device;
+    return (uint64_t(device()) << 32) | uint64_t(device());
+  }();
+  static std::atomic<uint64_t> counter(0);
+
+  return mix_hash(counter.fetch_add(1, std::memory_order_relaxed),
+                  process_seed);
+}
@@ -53,6 +53,17 @@ class LinkedList : public virtual IList<T, LinkedList<T>>,
   void rotate_left(size_t) override;
   void rotate_right(size_t) override;
   void swap(LinkedList<T> &) override;
+
+  /* Node Handles */
+  ListNode<T> *front_node();
+  ListNode<T> *back_node();
+  ListNode<T> *push_front_node(const T &);
+  void erase_node(ListNode<T> *);
+  void move_to_front(ListNode<T> *);
+
+ private:
+  void unlink(ListNode<T> *);
+  void link_front(ListNode<T> *);
 };
 
 /**
@@ -402,3 +413,111 @@ inline void LinkedList<T>::swap(LinkedList<T> &other) {
   other._size = _size;
   _size = temp_size;
 }
+
+/**
+ * @brief Get a handle to the node at the front of the list, or nullptr if the
+ * list is empty. Handles stay valid until their node is erased, so a caller
+ * can keep one to reach a node in O(1) later.
+ *
+ * @tparam T
+ * @return ListNode<T>*
+ */
+template <typename T>
+inline ListNode<T> *LinkedList<T>::front_node() {
+  return _head;
+}
+
+/**
+ * @brief Get a handle to the node at the back of the list, or nullptr if the
+ * list is empty.
+ *
+ * @tparam T
+ * @return ListNode<T>*
+ */
+template <typename T>
+inline ListNode<T> *LinkedList<T>::back_node() {
+  return _tail;
+}
+
+/**
+ * @brief Prepend a new node at the front of the list and return a handle to
+ * it.
+ *
+ * @tparam T
+ * @param value
+ * @return ListNode<T>*
+ */
+template <typename T>
+ListNode<T> *LinkedList<T>::push_front_node(const T &value) {
+  ListNode<T> *new_node = new ListNode<T>(value);
+  link_front(new_node);
+  _size++;
+  return new_node;
+}
+
+/**
+ * @brief Remove the node behind a handle from the list in O(1). Permanently.
+ *
+ * @tparam T
+ * @param node a handle to a node of this list
+ */
+template <typename T>
+void LinkedList<T>::erase_node(ListNode<T> *node) {
+  unlink(node);
+  delete node;
+  _size--;
+}
+
+/**
+ * @brief Move the node behind a handle to the front of the list in O(1). The
+ * handle stays valid.
+ *
+ * @tparam T
+ * @param node a handle to a node of this list
+ */
+template <typename T>
+void LinkedList<T>::move_to_front(ListNode<T> *node) {
+  if (node == _head) return;
+  unlink(node);
+  link_front(node);
+}
+
+/**
+ * @brief Detach a node from its neighbours without freeing it.
+ *
+ * @tparam T
+ * @param node
+ */
+template <typename T>
+void LinkedList<T>::unlink(ListNode<T> *node) {
+  if (node->_prev == nullptr) {
+    _head = node->_next;
+  } else {
+    node->_prev->_next = node->_next;
+  }
+
+  if (node->_next == nullptr) {
+    _tail = node->_prev;
+  } else {
+    node->_next->_prev = node->_prev;
+  }
+}
+
+/**
+ * @brief Attach a detached node at the front of the list.
+ *
+ * @tparam T
+ * @param node
+ */
+template <typename T>
+void LinkedList<T>::link_front(ListNode<T> *node) {
+  node->_prev = nullptr;
+  node->_next = _head;
+
+  if (_head == nullptr) {
+    _tail = node;
+  } else {
+    _head->_prev = node;
+  }
+  _head = node;
+}
@@ -17,14 +17,50 @@ class ListNode {
   ~ListNode();
 
   friend class LinkedList<T>;
+
+ public:
+  /* Accessors */
+  T &value();
+  ListNode<T> *prev();
+  ListNode<T> *next();
 };
 
 template <typename T>
-ListNode<T>::ListNode(const T &value) {
-  _value = value;
-  _prev = nullptr;
-  _next = nullptr;
-}
+ListNode<T>::ListNode(const T &value)
+    : _value(value), _prev(nullptr), _next(nullptr) {}
 
 template <typename T>
 ListNode<T>::~ListNode() {}
+
+/**
+ * @brief Get a reference to the value held by this node.
+ *
+ * @tparam T
+ * @return T&
+ */
+template <typename T>
+inline T &ListNode<T>::value() {
+  return _value;
+}
+
+/**
+ * @brief Get the node before this one, or nullptr at the front of the list.
+ *
+ * @tparam T
+ * @return ListNode<T>*
+ */
+template <typename T>
+inline ListNode<T> *ListNode<T>::prev() {
+  return _prev;
+}
+
+/**
+ * @brief Get the node after this one, or nullptr at the back of the list.
+ *
+ * @tparam T
+ * @return ListNode<T>*
+ */
+template <typename T>
+inline ListNode<T> *ListNode<T>::next() {
+  return _next;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file MallocAllocator.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A stateless allocator that gets storage from malloc and returns it
+ * with free. It is Vector's default allocator, so a Vector that does not name
+ * one allocates as it always has.
+ *
+ * Allocations of 1 MB or more are mapped directly with mmap instead. That lets
+ * reallocate grow them with mremap, which moves page table entries rather than
+ * copying bytes, so doubling a large buffer costs almost nothing and never
+ * holds two copies at once. Smaller buffers are grown with realloc.
+ *
+ * MallocAllocator<T> meets the standard Allocator requirements. Storage is
+ * aligned for any fundamental type, so T must not be over-aligned. Where
+ * mremap is unavailable, mapped buffers are grown by copying.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+template <typename T>
+class MallocAllocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "malloc does not align beyond max_align_t");
+
+ private:
+  /* Static Members */
+  static const size_t _map_threshold = size_t(1) << 20;
+
+  /* Helpers */
+  static size_t mapped_size(size_t);
+
+ public:
+  /* Typedefs */
+  typedef T value_type;
+  typedef std::true_type is_always_equal;
+
+  /* Constructors */
+  MallocAllocator() = default;
+  template <typename U>
+  MallocAllocator(const MallocAllocator<U> &);
+
+  /* Util */
+  static bool is_mapped(size_t);
+
+  /* Mutators */
+  T *allocate(size_t);
+  void deallocate(T *, size_t);
+  T *reallocate(T *, size_t, size_t);
+
+  /* Operators */
+  template <typename U>
+  bool operator==(const MallocAllocator<U> &) const;
+  template <typename U>
+  bool operator!=(const MallocAllocator<U> &) const;
+};
+
+/**
+ * @brief Returns the bytes mapped for n objects, rounded up to whole pages
+ *
+ * @tparam T
+ * @param n
+ * @return size_t
+ */
+template <typename T>
+size_t MallocAllocator<T>::mapped_size(size_t n) {
+  static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return (n * sizeof(T) + page - 1) & ~(page - 1);
+}
+
+/**
+ * @brief Rebind Constructor: MallocAllocator has no state to copy
+ *
+ * @tparam T
+ * @tparam U
+ */
+template <typename T>
+template <typename U>
+MallocAllocator<T>::MallocAllocator(const MallocAllocator<U> &) {}
+
+/**
+ * @brief Returns true if an allocation of n objects is mapped directly rather
+ * than taken from the heap
+ *
+ * @tparam T
+ * @param n
+ * @return bool
+ */
+template <typename T>
+bool MallocAllocator<T>::is_mapped(size_t n) {
+  return n * sizeof(T) >= _map_threshold;
+}
+
+/**
+ * @brief Allocate storage for n objects of type T. Throws std::bad_alloc on
+ * failure
+ *
+ * @tparam T
+ * @param n
+ * @return T*
+ */
+template <typename T>
+T *MallocAllocator<T>::allocate(size_t n) {
+  if (is_mapped(n)) {
+    void *p = mmap(nullptr, mapped_size(n), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+
+  T *p = static_cast<T *>(malloc(n * sizeof(T)));
+  if (!p && n) throw std::bad_alloc();
+  return p;
+}
+
+/**
+ * @brief Release storage obtained from allocate or reallocate
+ *
+ * @tparam T
+ * @param p
+ * @param n must match the count the storage was last allocated for
+ */
+template <typename T>
+void MallocAllocator<T>::deallocate(T *p, size_t n) {
+  if (is_mapped(n)) {
+    munmap(p, mapped_size(n));
+  } else {
+    free(p);
+  }
+}
+
+/**
+ * @brief Resize storage for old_n objects to hold new_n, keeping the first
+ * min(old_n, new_n) objects, and return its new address. The contents are
+ * moved as raw bytes, so T must be trivially copyable. Mapped storage is
+ * remapped and heap storage is realloc'd, so neither is copied where the
+ * platform can avoid it. Throws std::bad_alloc on failure, in which case p is
+ * left untouched
+ *
+ * @tparam T
+ * @param p storage from allocate or reallocate, or nullptr if old_n is 0
+ * @param old_n must match the count the storage was last allocated for
+ * @param new_n must not be 0
+ * @return T*
+ */
+template <typename T>
+T *MallocAllocator<T>::reallocate(T *p, size_t old_n, size_t new_n) {
+  if (!is_mapped(old_n) && !is_mapped(new_n)) {
+    T *q = static_cast<T *>(realloc(p, new_n * sizeof(T)));
+    if (!q) throw std::bad_alloc();
+    return q;
+  }
+
+#ifdef MREMAP_MAYMOVE
+  if (is_mapped(old_n) && is_mapped(new_n)) {
+    void *q =
+        mremap(p, mapped_size(old_n), mapped_size(new_n), MREMAP_MAYMOVE);
+    if (q == MAP_FAILED) throw std::bad_alloc();
+    return static_cast<T *>(q);
+  }
+#endif
+
+  T *q = allocate(new_n);
+  if (p) memcpy(q, p, (old_n < new_n ? old_n : new_n) * sizeof(T));
+  deallocate(p, old_n);
+  return q;
+}
+
+/**
+ * @brief Every MallocAllocator can free what any other allocated
+ *
+ * @tparam T
+ * @tparam U
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool MallocAllocator<T>::operator==(const MallocAllocator<U> &) const {
+  return true;
+}
+
+/**
+ * @brief Returns false, since MallocAllocators are always equal
+ *
+ * @tparam T
+ * @tparam U
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool MallocAllocator<T>::operator!=(const MallocAllocator<U> &) const {
+  return false;
+}
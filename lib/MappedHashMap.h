@@ -0,0 +1,445 @@
+/**
+ * @file MappedHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A read-only HashMap served straight from a memory-mapped snapshot
+ * file. MappedHashMap::save writes a HashMap out in a flat, position
+ * independent layout:
+ *
+ * - a header with the key and value sizes, the seed and the bucket count
+ * - bucket_count + 1 offsets, where bucket b owns entries offsets[b] up to
+ *   offsets[b + 1]
+ * - the entries themselves, grouped by bucket
+ *
+ * Opening a snapshot only maps the file and checks the header and bucket
+ * offsets, so a new process can answer get and has at once. Entry pages are
+ * read in lazily, the first time a lookup touches them, and are shared with
+ * every other process mapping the same file.
+ *
+ * K and V must be trivially copyable, and Hash must give the same output in
+ * every process that reads the file. std::hash for integers does.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "HashMapV1.h"
+#include "Hashing.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class MappedHashMap {
+  static_assert(std::is_trivially_copyable<K>::value &&
+                    std::is_trivially_copyable<V>::value,
+                "snapshots hold raw bytes of K and V");
+
+ private:
+  /* Inner Classes */
+  class Header {
+   public:
+    char _magic[8];
+    uint64_t _key_size;
+    uint64_t _value_size;
+    uint64_t _seed;
+    uint64_t _bucket_count;
+    uint64_t _size;
+  };
+
+  class Slot {
+   public:
+    K _key;
+    V _val;
+  };
+
+  /* Members */
+  void *_mapping;
+  size_t _mapping_size;
+  const Header *_header;
+  const uint64_t *_offsets;
+  const Slot *_entries;
+
+  /* Helpers */
+  static size_t entries_offset(uint64_t);
+  static size_t file_size(uint64_t, uint64_t);
+  static void fail(const std::string &);
+  bool well_formed() const;
+  const Slot *find(const K &) const;
+
+ public:
+  /* Constructors */
+  explicit MappedHashMap(const std::string &);
+  MappedHashMap(const MappedHashMap &) = delete;
+  MappedHashMap &operator=(const MappedHashMap &) = delete;
+  ~MappedHashMap();
+
+  /* Util */
+  bool is_empty() const;
+  size_t size() const;
+  bool has(const K &) const;
+
+  /* Accessors */
+  const V &get(const K &) const;
+
+  /* Mutators */
+  template <typename Alloc, typename Stats>
+  static void save(HashMap<K, V, Hash, Pred, Alloc, Stats> &,
+                   const std::string &);
+};
+
+/**
+ * @brief Returns the byte offset of the first entry in a snapshot with
+ * bucket_count buckets, rounded up to the alignment of an entry
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param bucket_count
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t MappedHashMap<K, V, Hash, Pred>::entries_offset(uint64_t bucket_count) {
+  size_t end = sizeof(Header) + (bucket_count + 1) * sizeof(uint64_t);
+  return (end + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+}
+
+/**
+ * @brief Returns the size in bytes of a snapshot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param bucket_count
+ * @param size number of entries
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t MappedHashMap<K, V, Hash, Pred>::file_size(uint64_t bucket_count,
+                                                  uint64_t size) {
+  return entries_offset(bucket_count) + size * sizeof(Slot);
+}
+
+/**
+ * @brief Throws std::system_error for the current errno
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param path
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void MappedHashMap<K, V, Hash, Pred>::fail(const std::string &path) {
+  throw std::system_error(errno, std::generic_category(), path);
+}
+
+/**
+ * @brief Returns true if the mapped file is a snapshot of this key and value
+ * type that lookups can trust. The counts in the header are bounded by the
+ * file size before file_size is called, so it cannot overflow, and the offsets
+ * must run from 0 up to the entry count without decreasing, so every bucket's
+ * range lies inside the entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool MappedHashMap<K, V, Hash, Pred>::well_formed() const {
+  uint64_t bucket_count = _header->_bucket_count;
+  uint64_t size = _header->_size;
+
+  if (memcmp(_header->_magic, "HMSNAP1", 8) ||
+      _header->_key_size != sizeof(K) || _header->_value_size != sizeof(V))
+    return false;
+
+  if (!bucket_count || bucket_count & (bucket_count - 1) ||
+      bucket_count >= (_mapping_size - sizeof(Header)) / sizeof(uint64_t) ||
+      size > _mapping_size / sizeof(Slot) ||
+      _mapping_size != file_size(bucket_count, size))
+    return false;
+
+  const uint64_t *offsets = reinterpret_cast<const uint64_t *>(
+      static_cast<const char *>(_mapping) + sizeof(Header));
+  if (offsets[0] || offsets[bucket_count] != size) return false;
+  for (uint64_t b = 0; b < bucket_count; b++) {
+    if (offsets[b] > offsets[b + 1]) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Returns the entry holding key, or nullptr if it is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return const Slot*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+const typename MappedHashMap<K, V, Hash, Pred>::Slot *
+MappedHashMap<K, V, Hash, Pred>::find(const K &key) const {
+  uint64_t b =
+      mix_hash(Hash()(key), _header->_seed) & (_header->_bucket_count - 1);
+
+  for (uint64_t i = _offsets[b]; i < _offsets[b + 1]; i++) {
+    if (Pred()(_entries[i]._key, key)) return &_entries[i];
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Map a snapshot written by save. Throws std::system_error if the file
+ * cannot be opened or mapped, and std::runtime_error if it is not a snapshot
+ * of this key and value type, or is truncated or corrupt
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param path
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+MappedHashMap<K, V, Hash, Pred>::MappedHashMap(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) fail(path);
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    close(fd);
+    fail(path);
+  }
+
+  _mapping_size = info.st_size;
+  if (_mapping_size < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error(path + ": not a HashMap snapshot");
+  }
+
+  _mapping = mmap(nullptr, _mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (_mapping == MAP_FAILED) fail(path);
+
+  _header = static_cast<const Header *>(_mapping);
+  if (!well_formed()) {
+    munmap(_mapping, _mapping_size);
+    throw std::runtime_error(path + ": not a HashMap snapshot");
+  }
+
+  // lookups land on random pages, so readahead would only waste I/O
+  madvise(_mapping, _mapping_size, MADV_RANDOM);
+
+  const char *base = static_cast<const char *>(_mapping);
+  _offsets = reinterpret_cast<const uint64_t *>(base + sizeof(Header));
+  _entries = reinterpret_cast<const Slot *>(
+      base + entries_offset(_header->_bucket_count));
+}
+
+/**
+ * @brief Unmap the snapshot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+MappedHashMap<K, V, Hash, Pred>::~MappedHashMap() {
+  munmap(_mapping, _mapping_size);
+}
+
+/**
+ * @brief Returns true if the snapshot holds no entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool MappedHashMap<K, V, Hash, Pred>::is_empty() const {
+  return !_header->_size;
+}
+
+/**
+ * @brief Returns the number of entries in the snapshot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t MappedHashMap<K, V, Hash, Pred>::size() const {
+  return _header->_size;
+}
+
+/**
+ * @brief Returns true if the snapshot contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool MappedHashMap<K, V, Hash, Pred>::has(const K &key) const {
+  return find(key);
+}
+
+/**
+ * @brief Returns the value associated with the provided key. The reference
+ * points into the mapping and is valid until the MappedHashMap is destroyed
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return const V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+const V &MappedHashMap<K, V, Hash, Pred>::get(const K &key) const {
+  const Slot *slot = find(key);
+  if (!slot) throw std::out_of_range("key not found");
+  return slot->_val;
+}
+
+/**
+ * @brief Write every entry of map to a snapshot file at path, replacing any
+ * file already there. The file's blocks are allocated up front and mapped, and
+ * entries are copied straight into their bucket's range, so saving needs no
+ * memory beyond the bucket offsets. There is one bucket per entry, rounded up
+ * to a power of two. Allocating first means a full disk fails the save with
+ * std::system_error rather than a SIGBUS part way through the copy.
+ *
+ * The snapshot is written to a uniquely named temporary file beside path,
+ * flushed to disk, then renamed over path. Processes that still map the old
+ * file keep reading it, concurrent saves never share a temporary file, and a
+ * crash part way through leaves either the old snapshot or the new one, never
+ * a torn file
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Alloc
+ * @tparam Stats
+ * @param map
+ * @param path
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+template <typename Alloc, typename Stats>
+void MappedHashMap<K, V, Hash, Pred>::save(
+    HashMap<K, V, Hash, Pred, Alloc, Stats> &map, const std::string &path) {
+  uint64_t bucket_count = 1;
+  while (bucket_count < map.size()) bucket_count *= 2;
+
+  uint64_t seed = random_seed();
+  uint64_t mask = bucket_count - 1;
+
+  // offsets[b + 1] counts bucket b, then a prefix sum turns counts into starts
+  std::vector<uint64_t> offsets(bucket_count + 1, 0);
+  map.for_each([&](const K &key, V &) {
+    offsets[(mix_hash(Hash()(key), seed) & mask) + 1]++;
+  });
+  for (uint64_t b = 0; b < bucket_count; b++) offsets[b + 1] += offsets[b];
+
+  size_t size = file_size(bucket_count, map.size());
+  std::string temp_path = path + ".XXXXXX";
+
+  int fd = mkstemp(&temp_path[0]);
+  if (fd < 0) fail(path);
+
+  // closes and removes the temporary file, then throws for errno
+  auto abandon = [&]() {
+    int error = errno;
+    close(fd);
+    unlink(temp_path.c_str());
+    errno = error;
+    fail(temp_path);
+  };
+
+  // mkstemp creates the file private to its owner
+  if (fchmod(fd, 0644) < 0) abandon();
+
+  int error = posix_fallocate(fd, 0, size);
+  if (error) {
+    errno = error;
+    abandon();
+  }
+
+  void *mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) abandon();
+
+  char *base = static_cast<char *>(mapping);
+  Header header;
+  memcpy(header._magic, "HMSNAP1", 8);
+  header._key_size = sizeof(K);
+  header._value_size = sizeof(V);
+  header._seed = seed;
+  header._bucket_count = bucket_count;
+  header._size = map.size();
+  memcpy(base, &header, sizeof(Header));
+  memcpy(base + sizeof(Header), offsets.data(),
+         offsets.size() * sizeof(uint64_t));
+
+  Slot *entries = reinterpret_cast<Slot *>(base + entries_offset(bucket_count));
+  map.for_each([&](const K &key, V &value) {
+    Slot *slot = &entries[offsets[mix_hash(Hash()(key), seed) & mask]++];
+    memcpy(&slot->_key, &key, sizeof(K));
+    memcpy(&slot->_val, &value, sizeof(V));
+  });
+
+  munmap(mapping, size);
+  if (fsync(fd) < 0) abandon();
+  close(fd);
+
+  if (rename(temp_path.c_str(), path.c_str()) < 0) {
+    int error = errno;
+    unlink(temp_path.c_str());
+    errno = error;
+    fail(path);
+  }
+
+  // make the rename itself durable
+  size_t slash = path.rfind('/');
+  std::string directory =
+      slash == std::string::npos ? "." : path.substr(0, slash + 1);
+  int dir_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+}
@@ -0,0 +1,484 @@
+/**
+ * @file RobinHoodHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief An open-addressing HashMap using Robin Hood hashing with linear
+ * probing. Every slot records how far it sits from its home bucket. An insert
+ * that is further from home than the resident of a slot takes that slot, and
+ * the displaced entry continues probing. This keeps probe lengths short and
+ * even. As a result:
+ *
+ * - an unsuccessful lookup stops at the first slot closer to home than itself
+ * - the table can run at a 0.9 load factor
+ * - erase shifts the following entries back one slot instead of leaving a
+ *   tombstone, so deletions never lengthen probes
+ *
+ * Distances are 16 bits by default. One byte would save a byte per slot, but
+ * a few hundred keys sharing a hash would then force the table to grow far
+ * past its contents just to keep every entry within 254 slots of home.
+ *
+ * The public interface mirrors HashMapV1.h so the two can be swapped.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Hashing.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K>, typename Distance = uint16_t>
+class RobinHoodHashMap {
+  static_assert(std::is_unsigned<Distance>::value,
+                "distances are stored as unsigned integers");
+
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    K _key;
+    V _val;
+
+    Slot(const K &, const V &);
+  };
+
+  /* Static Members */
+  static const size_t _min_capacity = 8;
+  static const size_t _max_distance = std::numeric_limits<Distance>::max();
+
+  /* Members */
+  size_t _size;
+  size_t _capacity;
+  Distance *_distances;
+  Slot *_slots;
+  uint64_t _seed;
+
+  /* Helpers */
+  uint64_t hash(const K &);
+  size_t find(const K &);
+  bool fits(const K &);
+  void place(Slot &&);
+  void resize(size_t);
+
+ public:
+  /* Constructors */
+  RobinHoodHashMap();
+  RobinHoodHashMap(const RobinHoodHashMap &) = delete;
+  RobinHoodHashMap &operator=(const RobinHoodHashMap &) = delete;
+  ~RobinHoodHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  size_t capacity();
+  double load_factor();
+  double max_load_factor();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Construct a new Slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+RobinHoodHashMap<K, V, Hash, Pred, Distance>::Slot::Slot(const K &key,
+                                                          const V &value)
+    : _key(key), _val(value) {}
+
+/**
+ * @brief Hash a key with this map's seed
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+uint64_t RobinHoodHashMap<K, V, Hash, Pred, Distance>::hash(const K &key) {
+  return mix_hash(Hash()(key), _seed);
+}
+
+/**
+ * @brief Returns the slot index holding key, or _capacity if it is absent.
+ * Distances are stored plus one, so that 0 means empty. The probe stops at the
+ * first slot whose resident is closer to home than key would be at that point,
+ * because an insert of key would have taken that slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+size_t RobinHoodHashMap<K, V, Hash, Pred, Distance>::find(const K &key) {
+  if (!_size) return _capacity;
+
+  size_t mask = _capacity - 1;
+  size_t index = hash(key) & mask;
+
+  for (size_t distance = 1;; distance++, index = (index + 1) & mask) {
+    if (_distances[index] < distance) return _capacity;
+    if (_distances[index] == distance && Pred()(_slots[index]._key, key))
+      return index;
+  }
+}
+
+/**
+ * @brief Returns true if key, which is absent, can be placed without any
+ * entry's distance outgrowing Distance. This walks the same slots place would,
+ * taking on each displaced resident's distance, without moving anything
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+bool RobinHoodHashMap<K, V, Hash, Pred, Distance>::fits(const K &key) {
+  size_t mask = _capacity - 1;
+  size_t index = hash(key) & mask;
+
+  for (size_t distance = 1;; distance++, index = (index + 1) & mask) {
+    if (distance == _max_distance) return false;
+    if (!_distances[index]) return true;
+    if (_distances[index] < distance) distance = _distances[index];
+  }
+}
+
+/**
+ * @brief Moves an entry whose key is absent into the table, displacing richer
+ * entries along the way. insert checks with fits first, and resize only ever
+ * spreads entries out, so no distance outgrows Distance
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param carry
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+void RobinHoodHashMap<K, V, Hash, Pred, Distance>::place(Slot &&carry) {
+  size_t mask = _capacity - 1;
+  size_t index = hash(carry._key) & mask;
+
+  for (size_t distance = 1;; distance++, index = (index + 1) & mask) {
+    if (!_distances[index]) {
+      new (&_slots[index]) Slot(std::move(carry));
+      _distances[index] = distance;
+      return;
+    }
+
+    if (_distances[index] < distance) {
+      std::swap(carry, _slots[index]);
+      size_t resident = _distances[index];
+      _distances[index] = distance;
+      distance = resident;
+    }
+  }
+}
+
+/**
+ * @brief Moves every entry into a fresh table of new_capacity slots
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param new_capacity must be a power of two
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+void RobinHoodHashMap<K, V, Hash, Pred, Distance>::resize(size_t new_capacity) {
+  size_t old_capacity = _capacity;
+  Distance *old_distances = _distances;
+  Slot *old_slots = _slots;
+
+  _capacity = new_capacity;
+  _distances = new Distance[_capacity]();
+  _slots = static_cast<Slot *>(::operator new(_capacity * sizeof(Slot)));
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (!old_distances[i]) continue;
+    place(std::move(old_slots[i]));
+    old_slots[i].~Slot();
+  }
+
+  delete[] old_distances;
+  ::operator delete(old_slots);
+}
+
+/**
+ * @brief Construct a new RobinHoodHashMap object. No storage is allocated
+ * until the first insert
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+RobinHoodHashMap<K, V, Hash, Pred, Distance>::RobinHoodHashMap()
+    : _size(0),
+      _capacity(0),
+      _distances(nullptr),
+      _slots(nullptr),
+      _seed(random_seed()) {}
+
+/**
+ * @brief Destroy the RobinHoodHashMap object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+RobinHoodHashMap<K, V, Hash, Pred, Distance>::~RobinHoodHashMap() {
+  for (size_t i = 0; i < _capacity; i++) {
+    if (_distances[i]) _slots[i].~Slot();
+  }
+  delete[] _distances;
+  ::operator delete(_slots);
+}
+
+/**
+ * @brief Returns true if RobinHoodHashMap is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+bool RobinHoodHashMap<K, V, Hash, Pred, Distance>::is_empty() {
+  return !_size;
+}
+
+/**
+ * @brief Returns the number of entries stored in the RobinHoodHashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+size_t RobinHoodHashMap<K, V, Hash, Pred, Distance>::size() {
+  return _size;
+}
+
+/**
+ * @brief Returns the current number of slots
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+size_t RobinHoodHashMap<K, V, Hash, Pred, Distance>::capacity() {
+  return _capacity;
+}
+
+/**
+ * @brief Returns the ratio of size / capacity
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+double RobinHoodHashMap<K, V, Hash, Pred, Distance>::load_factor() {
+  return double(_size) / double(_capacity);
+}
+
+/**
+ * @brief Returns the load factor past which an insert doubles the table
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @return double
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+double RobinHoodHashMap<K, V, Hash, Pred, Distance>::max_load_factor() {
+  return 0.9;
+}
+
+/**
+ * @brief Returns true if RobinHoodHashMap contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+bool RobinHoodHashMap<K, V, Hash, Pred, Distance>::has(const K &key) {
+  return find(key) != _capacity;
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+V &RobinHoodHashMap<K, V, Hash, Pred, Distance>::get(const K &key) {
+  size_t index = find(key);
+  if (index == _capacity) throw std::out_of_range("key not found");
+  return _slots[index]._val;
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair. If the new entry would leave
+ * some entry too far from home for Distance to record, the table doubles until
+ * it fits. With the default 16-bit Distance, only a Hash that gives tens of
+ * thousands of keys the same value can keep that from working. Once the table
+ * would be 64 times larger than its contents, it goes back to the capacity it
+ * had before the doubling and this throws std::overflow_error, leaving every
+ * other entry in place
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+void RobinHoodHashMap<K, V, Hash, Pred, Distance>::insert(const K &key,
+                                                          const V &value) {
+  size_t index = find(key);
+  if (index != _capacity) {
+    _slots[index]._val = value;
+    return;
+  }
+
+  if (!_capacity) {
+    resize(_min_capacity);
+  } else if ((_size + 1) * 10 > _capacity * 9) {
+    resize(_capacity * 2);
+  }
+
+  size_t capacity = _capacity;
+  while (!fits(key)) {
+    if (_capacity >= (_size + 1) * 64) {
+      if (_capacity != capacity) resize(capacity);
+      throw std::overflow_error("hash collisions");
+    }
+    resize(_capacity * 2);
+  }
+
+  place(Slot(key, value));
+  _size++;
+}
+
+/**
+ * @brief Delete a key/value pair. Each following entry that is not in its home
+ * slot moves back one slot, until an empty slot or an entry at home is reached
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam Distance
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred,
+          typename Distance>
+void RobinHoodHashMap<K, V, Hash, Pred, Distance>::erase(const K &key) {
+  size_t index = find(key);
+  if (index == _capacity) return;
+
+  size_t mask = _capacity - 1;
+  size_t next = (index + 1) & mask;
+
+  _slots[index].~Slot();
+
+  while (_distances[next] > 1) {
+    new (&_slots[index]) Slot(std::move(_slots[next]));
+    _slots[next].~Slot();
+    _distances[index] = _distances[next] - 1;
+
+    index = next;
+    next = (next + 1) & mask;
+  }
+
+  _distances[index] = 0;
+  _size--;
+}
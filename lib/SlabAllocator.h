@@ -0,0 +1,295 @@
+/**
+ * @file SlabAllocator.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A pool allocator for node-based containers. Objects are carved out of
+ * large slabs with a bump pointer. Freed objects go onto a free list for their
+ * size class and are handed out again before the slab grows, so a container
+ * that inserts and erases at a steady size stops calling malloc entirely.
+ *
+ * SlabAllocator<T> meets the standard Allocator requirements. Copies and
+ * rebinds share one SlabPool, which is freed along with every slab once the
+ * last allocator referring to it is destroyed. The pool is not thread-safe.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+class SlabPool {
+ private:
+  /* Inner Classes */
+  class FreeNode {
+   public:
+    FreeNode *_next;
+  };
+
+  /* Static Members */
+  static const size_t _granularity = 16;
+  static const size_t _max_object_size = 256;
+  static const size_t _size_classes = _max_object_size / _granularity;
+  static const size_t _slab_size = 64 * 1024;
+
+  /* Members */
+  FreeNode *_free_lists[_size_classes];
+  FreeNode *_slabs;
+  char *_cursor;
+  char *_end;
+  size_t _refs;
+
+  template <typename T>
+  friend class SlabAllocator;
+
+ public:
+  /* Constructors */
+  SlabPool();
+  SlabPool(const SlabPool &) = delete;
+  SlabPool &operator=(const SlabPool &) = delete;
+  ~SlabPool();
+
+  /* Util */
+  static bool is_poolable(size_t, size_t);
+
+  /* Mutators */
+  void *allocate(size_t);
+  void deallocate(void *, size_t);
+};
+
+template <typename T>
+class SlabAllocator {
+ public:
+  /* Typedefs */
+  typedef T value_type;
+  typedef std::false_type is_always_equal;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  /* Constructors */
+  SlabAllocator();
+  SlabAllocator(const SlabAllocator &);
+  template <typename U>
+  SlabAllocator(const SlabAllocator<U> &);
+  SlabAllocator &operator=(const SlabAllocator &);
+  ~SlabAllocator();
+
+  /* Mutators */
+  T *allocate(size_t);
+  void deallocate(T *, size_t);
+
+  /* Operators */
+  template <typename U>
+  bool operator==(const SlabAllocator<U> &) const;
+  template <typename U>
+  bool operator!=(const SlabAllocator<U> &) const;
+
+ private:
+  SlabPool *_pool;
+
+  template <typename U>
+  friend class SlabAllocator;
+};
+
+/**
+ * @brief Construct an empty SlabPool. The first slab is allocated lazily
+ */
+inline SlabPool::SlabPool()
+    : _free_lists(),
+      _slabs(nullptr),
+      _cursor(nullptr),
+      _end(nullptr),
+      _refs(1) {}
+
+/**
+ * @brief Destroy the SlabPool, releasing every slab. Objects still living in
+ * the pool are not destroyed
+ */
+inline SlabPool::~SlabPool() {
+  while (_slabs) {
+    FreeNode *next_slab = _slabs->_next;
+    ::operator delete(_slabs);
+    _slabs = next_slab;
+  }
+}
+
+/**
+ * @brief Returns true if an allocation of this size and alignment is served
+ * from the slabs. Anything else goes straight to operator new
+ *
+ * @param bytes
+ * @param alignment
+ * @return bool
+ */
+inline bool SlabPool::is_poolable(size_t bytes, size_t alignment) {
+  return bytes && bytes <= _max_object_size && alignment <= _granularity;
+}
+
+/**
+ * @brief Allocate bytes of storage. The request is rounded up to a multiple of
+ * 16 bytes. It is served from that size class's free list if possible, and
+ * otherwise bumped from the current slab
+ *
+ * @param bytes
+ * @return void*
+ */
+inline void *SlabPool::allocate(size_t bytes) {
+  size_t size_class = (bytes - 1) / _granularity;
+  FreeNode *node = _free_lists[size_class];
+
+  if (node) {
+    _free_lists[size_class] = node->_next;
+    return node;
+  }
+
+  size_t rounded = (size_class + 1) * _granularity;
+  if (size_t(_end - _cursor) < rounded) {
+    // the first 16 bytes of every slab link it into _slabs
+    FreeNode *slab = static_cast<FreeNode *>(::operator new(_slab_size));
+    slab->_next = _slabs;
+    _slabs = slab;
+    _cursor = reinterpret_cast<char *>(slab) + _granularity;
+    _end = reinterpret_cast<char *>(slab) + _slab_size;
+  }
+
+  void *p = _cursor;
+  _cursor += rounded;
+  return p;
+}
+
+/**
+ * @brief Return storage to its size class's free list
+ *
+ * @param p
+ * @param bytes must match the size passed to allocate
+ */
+inline void SlabPool::deallocate(void *p, size_t bytes) {
+  size_t size_class = (bytes - 1) / _granularity;
+  FreeNode *node = static_cast<FreeNode *>(p);
+  node->_next = _free_lists[size_class];
+  _free_lists[size_class] = node;
+}
+
+/**
+ * @brief Default Constructor: get an allocator with a fresh pool
+ *
+ * @tparam T
+ */
+template <typename T>
+SlabAllocator<T>::SlabAllocator() : _pool(new SlabPool()) {}
+
+/**
+ * @brief Copy Constructor: share other's pool
+ *
+ * @tparam T
+ * @param other
+ */
+template <typename T>
+SlabAllocator<T>::SlabAllocator(const SlabAllocator &other)
+    : _pool(other._pool) {
+  _pool->_refs++;
+}
+
+/**
+ * @brief Rebind Constructor: share other's pool
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ */
+template <typename T>
+template <typename U>
+SlabAllocator<T>::SlabAllocator(const SlabAllocator<U> &other)
+    : _pool(other._pool) {
+  _pool->_refs++;
+}
+
+/**
+ * @brief Copy Assignment: release the current pool and share other's
+ *
+ * @tparam T
+ * @param other
+ * @return SlabAllocator<T>&
+ */
+template <typename T>
+SlabAllocator<T> &SlabAllocator<T>::operator=(const SlabAllocator &other) {
+  other._pool->_refs++;
+  if (!--_pool->_refs) delete _pool;
+  _pool = other._pool;
+  return *this;
+}
+
+/**
+ * @brief Destroy the SlabAllocator. The last allocator sharing a pool frees it
+ *
+ * @tparam T
+ */
+template <typename T>
+SlabAllocator<T>::~SlabAllocator() {
+  if (!--_pool->_refs) delete _pool;
+}
+
+/**
+ * @brief Allocate storage for n objects of type T. Single small objects come
+ * from the pool. Arrays and large objects fall back to operator new
+ *
+ * @tparam T
+ * @param n
+ * @return T*
+ */
+template <typename T>
+T *SlabAllocator<T>::allocate(size_t n) {
+  if (n == 1 && SlabPool::is_poolable(sizeof(T), alignof(T)))
+    return static_cast<T *>(_pool->allocate(sizeof(T)));
+  return static_cast<T *>(::operator new(n * sizeof(T)));
+}
+
+/**
+ * @brief Release storage obtained from allocate
+ *
+ * @tparam T
+ * @param p
+ * @param n must match the count passed to allocate
+ */
+template <typename T>
+void SlabAllocator<T>::deallocate(T *p, size_t n) {
+  if (n == 1 && SlabPool::is_poolable(sizeof(T), alignof(T))) {
+    _pool->deallocate(p, sizeof(T));
+  } else {
+    ::operator delete(p);
+  }
+}
+
+/**
+ * @brief Two allocators are equal if they share a pool, meaning either can free
+ * what the other allocated
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool SlabAllocator<T>::operator==(const SlabAllocator<U> &other) const {
+  return _pool == other._pool;
+}
+
+/**
+ * @brief Returns true if the allocators do not share a pool
+ *
+ * @tparam T
+ * @tparam U
+ * @param other
+ * @return bool
+ */
+template <typename T>
+template <typename U>
+bool SlabAllocator<T>::operator!=(const SlabAllocator<U> &other) const {
+  return _pool != other._pool;
+}
@@ -0,0 +1,382 @@
+/**
+ * @file SmallHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A HashMap for maps that usually stay tiny, such as per-object
+ * attribute bags. Up to N entries live inline in the SmallHashMap object itself
+ * and are found by comparing keys one by one, without hashing. A map of at
+ * most N entries therefore makes no allocations at all, and its entries share
+ * the cache lines of the object that owns it.
+ *
+ * Inserting an N + 1th key moves every entry into a heap-allocated HashMap,
+ * and the map stays hashed from then on, even if it later shrinks. For small N
+ * a linear scan beats hashing, since the whole array fits in a line or two.
+ *
+ * The public interface mirrors HashMapV1.h so the two can be swapped.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "HashMapV1.h"
+
+template <typename K, typename V, size_t N = 8, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class SmallHashMap {
+  static_assert(N > 0, "SmallHashMap needs room for at least one entry");
+
+ private:
+  /* Inner Classes */
+  class Slot {
+   public:
+    K _key;
+    V _val;
+
+    template <typename KArg, typename VArg>
+    Slot(KArg &&, VArg &&);
+  };
+
+  /* Members */
+  size_t _small_size;
+  HashMap<K, V, Hash, Pred> *_large;
+  alignas(Slot) unsigned char _storage[N * sizeof(Slot)];
+
+  /* Helpers */
+  Slot *slot(size_t);
+  Slot *find_slot(const K &);
+  void upgrade();
+
+ public:
+  /* Constructors */
+  SmallHashMap();
+  SmallHashMap(const SmallHashMap &) = delete;
+  SmallHashMap &operator=(const SmallHashMap &) = delete;
+  ~SmallHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  bool is_small();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+  V *find(const K &);
+  template <typename F>
+  void for_each(F &&);
+
+  /* Mutators */
+  void insert(const K &, const V &);
+  void erase(const K &);
+};
+
+/**
+ * @brief Construct a new Slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam KArg
+ * @tparam VArg
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+template <typename KArg, typename VArg>
+SmallHashMap<K, V, N, Hash, Pred>::Slot::Slot(KArg &&key, VArg &&value)
+    : _key(std::forward<KArg>(key)), _val(std::forward<VArg>(value)) {}
+
+/**
+ * @brief Returns the i-th inline slot. It only holds an entry if i is below
+ * _small_size
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param i
+ * @return Slot*
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+typename SmallHashMap<K, V, N, Hash, Pred>::Slot *
+SmallHashMap<K, V, N, Hash, Pred>::slot(size_t i) {
+  return reinterpret_cast<Slot *>(_storage) + i;
+}
+
+/**
+ * @brief Returns the inline slot holding key, or nullptr if it is absent
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return Slot*
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+typename SmallHashMap<K, V, N, Hash, Pred>::Slot *
+SmallHashMap<K, V, N, Hash, Pred>::find_slot(const K &key) {
+  for (size_t i = 0; i < _small_size; i++) {
+    if (Pred()(slot(i)->_key, key)) return slot(i);
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Moves every inline entry into a new HashMap with room for N + 1
+ * entries. Entries are copied, and the inline ones destroyed only once every
+ * copy is in place, so a failed upgrade leaves the map as it was. This costs
+ * N extra copies, once per map
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+void SmallHashMap<K, V, N, Hash, Pred>::upgrade() {
+  HashMap<K, V, Hash, Pred> *large = new HashMap<K, V, Hash, Pred>();
+  try {
+    large->reserve(N + 1);
+    for (size_t i = 0; i < _small_size; i++) {
+      large->try_emplace(slot(i)->_key, slot(i)->_val);
+    }
+  } catch (...) {
+    delete large;
+    throw;
+  }
+
+  for (size_t i = 0; i < _small_size; i++) slot(i)->~Slot();
+  _small_size = 0;
+  _large = large;
+}
+
+/**
+ * @brief Construct an empty SmallHashMap. Nothing is allocated
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+SmallHashMap<K, V, N, Hash, Pred>::SmallHashMap()
+    : _small_size(0), _large(nullptr) {}
+
+/**
+ * @brief Destroy the SmallHashMap object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+SmallHashMap<K, V, N, Hash, Pred>::~SmallHashMap() {
+  for (size_t i = 0; i < _small_size; i++) slot(i)->~Slot();
+  delete _large;
+}
+
+/**
+ * @brief Returns true if SmallHashMap is empty
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+bool SmallHashMap<K, V, N, Hash, Pred>::is_empty() {
+  return !size();
+}
+
+/**
+ * @brief Returns the number of entries
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+size_t SmallHashMap<K, V, N, Hash, Pred>::size() {
+  return _large ? _large->size() : _small_size;
+}
+
+/**
+ * @brief Returns true while the entries are still stored inline
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+bool SmallHashMap<K, V, N, Hash, Pred>::is_small() {
+  return !_large;
+}
+
+/**
+ * @brief Returns true if SmallHashMap contains the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+bool SmallHashMap<K, V, N, Hash, Pred>::has(const K &key) {
+  return find(key);
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+V &SmallHashMap<K, V, N, Hash, Pred>::get(const K &key) {
+  V *value = find(key);
+  if (!value) throw std::out_of_range("key not found");
+  return *value;
+}
+
+/**
+ * @brief Returns a pointer to the value associated with the provided key, or
+ * nullptr if it is absent. The pointer is valid until the next insert or erase
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+V *SmallHashMap<K, V, N, Hash, Pred>::find(const K &key) {
+  if (_large) return _large->find(key);
+
+  Slot *found = find_slot(key);
+  return found ? &found->_val : nullptr;
+}
+
+/**
+ * @brief Calls visit(key, value) once for every entry, in no particular order.
+ * visit must not insert into or erase from the SmallHashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @tparam F callable as void(const K &, V &)
+ * @param visit
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+template <typename F>
+void SmallHashMap<K, V, N, Hash, Pred>::for_each(F &&visit) {
+  if (_large) {
+    _large->for_each(visit);
+    return;
+  }
+
+  for (size_t i = 0; i < _small_size; i++) {
+    const K &key = slot(i)->_key;
+    visit(key, slot(i)->_val);
+  }
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair. Inserting a new key into a full
+ * inline array first moves every entry to a HashMap
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+void SmallHashMap<K, V, N, Hash, Pred>::insert(const K &key, const V &value) {
+  if (!_large) {
+    Slot *found = find_slot(key);
+    if (found) {
+      found->_val = value;
+      return;
+    }
+
+    if (_small_size < N) {
+      new (slot(_small_size)) Slot(key, value);
+      _small_size++;
+      return;
+    }
+
+    upgrade();
+  }
+
+  _large->insert(key, value);
+}
+
+/**
+ * @brief Delete a key/value pair. In the inline array, the last entry moves
+ * into the erased one's slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam N
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ */
+template <typename K, typename V, size_t N, typename Hash, typename Pred>
+void SmallHashMap<K, V, N, Hash, Pred>::erase(const K &key) {
+  if (_large) {
+    _large->erase(key);
+    return;
+  }
+
+  Slot *found = find_slot(key);
+  if (!found) return;
+
+  Slot *last = slot(_small_size - 1);
+  if (found != last) {
+    found->_key = std::move(last->_key);
+    found->_val = std::move(last->_val);
+  }
+  last->~Slot();
+  _small_size--;
+}
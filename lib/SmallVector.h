@@ -0,0 +1,414 @@
+/**
+ * @file SmallVector.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A Vector for sequences that usually stay short, such as the fields of
+ * one record. Up to N elements live inline in the SmallVector object itself,
+ * so a SmallVector that never outgrows N makes no allocations at all, and
+ * starts with capacity N instead of growing 1, 2, 4, ... from nothing.
+ *
+ * Growing past N moves every element to the heap, and the SmallVector behaves
+ * like an ordinary Vector from then on. shrink_to_fit and clear bring the
+ * elements back inline once they fit again.
+ *
+ * SmallVector is a Vector whose allocator hands out the inline buffer, so the
+ * public interface and growth behaviour match Vector.h, and trivially copyable
+ * elements on the heap grow with realloc like any other Vector.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "MallocAllocator.h"
+#include "Vector.h"
+
+template <typename T, size_t N>
+class InlineAllocator {
+ private:
+  /* Members */
+  T *_buffer;
+  bool _in_use;
+
+ public:
+  /* Typedefs */
+  typedef T value_type;
+  typedef std::false_type is_always_equal;
+
+  /* Constructors */
+  explicit InlineAllocator(T *);
+
+  /* Util */
+  bool is_inline(const T *) const;
+
+  /* Mutators */
+  T *allocate(size_t);
+  void deallocate(T *, size_t);
+  T *reallocate(T *, size_t, size_t);
+
+  /* Operators */
+  bool operator==(const InlineAllocator &) const;
+  bool operator!=(const InlineAllocator &) const;
+};
+
+template <typename T, size_t N>
+class SmallVector : private Vector<T, InlineAllocator<T, N> > {
+  static_assert(N > 0, "SmallVector needs room for at least one element");
+
+ private:
+  typedef Vector<T, InlineAllocator<T, N> > Base;
+
+  /* Members */
+  alignas(T) unsigned char _storage[N * sizeof(T)];
+
+  /* Helpers */
+  T *buffer();
+  void take(SmallVector &);
+
+ public:
+  /* Constructors */
+  SmallVector();
+  explicit SmallVector(size_t);
+  SmallVector(size_t, const T &);
+  SmallVector(const SmallVector &) = delete;
+  SmallVector &operator=(const SmallVector &) = delete;
+  SmallVector(SmallVector &&) noexcept(
+      std::is_nothrow_move_constructible<T>::value);
+  SmallVector &operator=(SmallVector &&) noexcept(
+      std::is_nothrow_move_constructible<T>::value);
+
+  /* Util */
+  using Base::capacity;
+  using Base::index_of;
+  using Base::is_empty;
+  using Base::size;
+  bool is_small();
+
+  /* Accessors */
+  using Base::at;
+  using Base::back;
+  using Base::count;
+  using Base::data;
+  using Base::find;
+  using Base::front;
+  using Base::max;
+  using Base::min;
+  using Base::operator[];
+  using Base::sum;
+
+  /* Mutators */
+  using Base::assign;
+  using Base::emplace;
+  using Base::emplace_back;
+  using Base::insert;
+  using Base::pop;
+  using Base::pop_back;
+  using Base::push;
+  using Base::push_back;
+  using Base::remove;
+  using Base::reserve;
+  using Base::resize;
+  using Base::reverse;
+  void shrink_to_fit();
+  void swap(SmallVector &) noexcept(
+      std::is_nothrow_move_constructible<T>::value);
+  void clear();
+};
+
+/**
+ * @brief Construct an allocator that hands out buffer, which must hold N
+ * objects of type T
+ *
+ * @tparam T
+ * @tparam N
+ * @param buffer
+ */
+template <typename T, size_t N>
+InlineAllocator<T, N>::InlineAllocator(T *buffer)
+    : _buffer(buffer), _in_use(false) {}
+
+/**
+ * @brief Returns true if p is the inline buffer
+ *
+ * @tparam T
+ * @tparam N
+ * @param p
+ * @return bool
+ */
+template <typename T, size_t N>
+bool InlineAllocator<T, N>::is_inline(const T *p) const {
+  return p == _buffer;
+}
+
+/**
+ * @brief Allocate storage for n objects of type T. The inline buffer is used
+ * if n fits and it is free, and the heap otherwise
+ *
+ * @tparam T
+ * @tparam N
+ * @param n
+ * @return T*
+ */
+template <typename T, size_t N>
+T *InlineAllocator<T, N>::allocate(size_t n) {
+  if (n <= N && !_in_use) {
+    _in_use = true;
+    return _buffer;
+  }
+  return MallocAllocator<T>().allocate(n);
+}
+
+/**
+ * @brief Release storage obtained from allocate or reallocate
+ *
+ * @tparam T
+ * @tparam N
+ * @param p
+ * @param n must match the count the storage was last allocated for
+ */
+template <typename T, size_t N>
+void InlineAllocator<T, N>::deallocate(T *p, size_t n) {
+  if (is_inline(p)) {
+    _in_use = false;
+  } else {
+    MallocAllocator<T>().deallocate(p, n);
+  }
+}
+
+/**
+ * @brief Resize storage for old_n objects to hold new_n. The inline buffer is
+ * kept while new_n fits, and heap storage that stays on the heap is resized by
+ * MallocAllocator. The contents are moved as raw bytes, so T must be trivially
+ * copyable
+ *
+ * @tparam T
+ * @tparam N
+ * @param p
+ * @param old_n must match the count the storage was last allocated for
+ * @param new_n
+ * @return T*
+ */
+template <typename T, size_t N>
+T *InlineAllocator<T, N>::reallocate(T *p, size_t old_n, size_t new_n) {
+  if (is_inline(p) && new_n <= N) return p;
+  if (!is_inline(p) && new_n > N) {
+    return MallocAllocator<T>().reallocate(p, old_n, new_n);
+  }
+
+  T *q = allocate(new_n);
+  memcpy(q, p, (old_n < new_n ? old_n : new_n) * sizeof(T));
+  deallocate(p, old_n);
+  return q;
+}
+
+/**
+ * @brief Two allocators are equal if they hand out the same inline buffer
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ * @return bool
+ */
+template <typename T, size_t N>
+bool InlineAllocator<T, N>::operator==(const InlineAllocator &other) const {
+  return _buffer == other._buffer;
+}
+
+/**
+ * @brief Returns true if the allocators hand out different inline buffers
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ * @return bool
+ */
+template <typename T, size_t N>
+bool InlineAllocator<T, N>::operator!=(const InlineAllocator &other) const {
+  return _buffer != other._buffer;
+}
+
+/**
+ * @brief Returns the inline buffer
+ *
+ * @tparam T
+ * @tparam N
+ * @return T*
+ */
+template <typename T, size_t N>
+T *SmallVector<T, N>::buffer() {
+  return reinterpret_cast<T *>(_storage);
+}
+
+/**
+ * @brief Replaces this SmallVector's elements with other's, leaving other
+ * empty. Heap storage changes owners by swapping pointers, in O(1). Inline
+ * elements cannot, so they are moved one by one, which needs no allocation
+ * since they fit this SmallVector's own buffer
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ */
+template <typename T, size_t N>
+void SmallVector<T, N>::take(SmallVector &other) {
+  if (other.is_small()) {
+    clear();
+    for (size_t i = 0; i < other.size(); i++) {
+      Base::emplace_back(std::move(other[i]));
+    }
+    other.clear();
+    return;
+  }
+
+  // release this inline buffer too, so only heap storage changes hands
+  Base::clear();
+  Base::swap_storage(other);
+  other.Base::reserve(N);
+}
+
+/**
+ * @brief Construct an empty SmallVector with capacity N. Nothing is allocated
+ *
+ * @tparam T
+ * @tparam N
+ */
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector()
+    : Base(InlineAllocator<T, N>(reinterpret_cast<T *>(_storage))) {
+  Base::reserve(N);
+}
+
+/**
+ * @brief Construct a SmallVector of k value-initialized elements, stored inline
+ * if k is at most N
+ *
+ * @tparam T
+ * @tparam N
+ * @param k
+ */
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(size_t k)
+    : Base(InlineAllocator<T, N>(reinterpret_cast<T *>(_storage))) {
+  Base::reserve(k > N ? k : N);
+  Base::resize(k);
+}
+
+/**
+ * @brief Construct a SmallVector of k copies of val, stored inline if k is at
+ * most N
+ *
+ * @tparam T
+ * @tparam N
+ * @param k
+ * @param val
+ */
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(size_t k, const T &val)
+    : Base(InlineAllocator<T, N>(reinterpret_cast<T *>(_storage))) {
+  Base::reserve(k > N ? k : N);
+  Base::resize(k, val);
+}
+
+/**
+ * @brief Move Constructor: take other's elements, leaving it empty. O(1) if
+ * other is on the heap
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ */
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector &&other) noexcept(
+    std::is_nothrow_move_constructible<T>::value)
+    : SmallVector() {
+  take(other);
+}
+
+/**
+ * @brief Move Assignment: destroy this SmallVector's elements and take
+ * other's, leaving it empty. O(size()) to destroy the old elements, plus O(1)
+ * if other is on the heap
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ * @return SmallVector&
+ */
+template <typename T, size_t N>
+SmallVector<T, N> &SmallVector<T, N>::operator=(SmallVector &&other) noexcept(
+    std::is_nothrow_move_constructible<T>::value) {
+  if (this != &other) take(other);
+  return *this;
+}
+
+/**
+ * @brief Returns true while the elements are stored inline
+ *
+ * @tparam T
+ * @tparam N
+ * @return bool
+ */
+template <typename T, size_t N>
+bool SmallVector<T, N>::is_small() {
+  return data() == buffer();
+}
+
+/**
+ * @brief Shrink capacity to equal size. If the elements fit inline, they move
+ * back into the inline buffer and capacity becomes N
+ *
+ * @tparam T
+ * @tparam N
+ */
+template <typename T, size_t N>
+void SmallVector<T, N>::shrink_to_fit() {
+  if (is_small()) return;
+  if (size() > N) {
+    Base::shrink_to_fit();
+    return;
+  }
+
+  // the inline buffer is free, so a Vector sharing the allocator gets it
+  Base small(Base::get_allocator());
+  small.reserve(N);
+  for (size_t i = 0; i < size(); i++) {
+    small.emplace_back(std::move((*this)[i]));
+  }
+  Base::swap(small);
+}
+
+/**
+ * @brief Swap elements with another SmallVector. O(1) if both are on the heap,
+ * and otherwise O(N) element moves
+ *
+ * @tparam T
+ * @tparam N
+ * @param other
+ */
+template <typename T, size_t N>
+void SmallVector<T, N>::swap(SmallVector &other) noexcept(
+    std::is_nothrow_move_constructible<T>::value) {
+  SmallVector temp(std::move(other));
+  other.take(*this);
+  take(temp);
+}
+
+/**
+ * @brief Destroy every element and free any heap storage, leaving an empty
+ * SmallVector with capacity N
+ *
+ * @tparam T
+ * @tparam N
+ */
+template <typename T, size_t N>
+void SmallVector<T, N>::clear() {
+  Base::clear();
+  Base::reserve(N);
+}
@@ -0,0 +1,448 @@
+/**
+ * @file TTLHashMap.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief A HashMap whose entries expire a fixed number of ticks after they are
+ * inserted. The caller owns the clock: advance moves it forward, and a tick
+ * can stand for any unit of time.
+ *
+ * Deadlines are kept in a hierarchical timing wheel of four levels. Each level
+ * is a ring of 64 slots, indexed like a CircularBuffer, where level l slot s
+ * holds the entries that are due in the s-th 64^l tick window of the level's
+ * current revolution. Each slot is an intrusive doubly linked list, so
+ * scheduling and cancelling a deadline are O(1). When a level completes a
+ * revolution, the next slot of the level above is emptied and its entries are
+ * moved down to finer slots. Each entry moves at most three times, so expiry
+ * costs O(1) per tick plus amortized O(1) per expired entry. Deadlines more
+ * than 2^24 ticks away wait in the top level and are placed again each time
+ * it completes a revolution.
+ *
+ * Turning the wheel is left to expire, so advancing the clock is O(1). Reads
+ * check the deadline themselves and erase an entry that is past it, so an
+ * expired value is never returned, however rarely expire runs.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#include "HashMapV1.h"
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Pred = std::equal_to<K> >
+class TTLHashMap {
+ private:
+  /* Inner Classes */
+  class Timer {
+   public:
+    K _key;
+    V _val;
+    uint64_t _deadline;
+    Timer **_link;
+    Timer *_next;
+
+    Timer(const K &, const V &, uint64_t);
+  };
+
+  /* Static Members */
+  static const unsigned _slot_bits = 6;
+  static const size_t _slots = size_t(1) << _slot_bits;
+  static const size_t _levels = 4;
+
+  /* Members */
+  uint64_t _now;
+  uint64_t _wheel_time;
+  HashMap<K, Timer *, Hash, Pred> _index;
+  Timer *_wheel[_levels][_slots];
+
+  /* Helpers */
+  void schedule(Timer *);
+  static void unlink(Timer *);
+  void remove(Timer *);
+  size_t turn();
+
+ public:
+  /* Constructors */
+  TTLHashMap();
+  TTLHashMap(const TTLHashMap &) = delete;
+  TTLHashMap &operator=(const TTLHashMap &) = delete;
+  ~TTLHashMap();
+
+  /* Util */
+  bool is_empty();
+  size_t size();
+  uint64_t now();
+  bool has(const K &);
+
+  /* Accessors */
+  V &get(const K &);
+  V *find(const K &);
+
+  /* Mutators */
+  void insert(const K &, const V &, uint64_t);
+  void erase(const K &);
+  void advance(uint64_t);
+  size_t expire();
+};
+
+/**
+ * @brief Construct a new Timer that is not yet in any slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ * @param deadline the tick at which the entry expires
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+TTLHashMap<K, V, Hash, Pred>::Timer::Timer(const K &key, const V &value,
+                                           uint64_t deadline)
+    : _key(key),
+      _val(value),
+      _deadline(deadline),
+      _link(nullptr),
+      _next(nullptr) {}
+
+/**
+ * @brief Puts a timer in the finest slot that ends at or before its deadline,
+ * measured from the wheel's position. A deadline the wheel has already reached
+ * goes in the current level 0 slot, which turn empties next
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param timer
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::schedule(Timer *timer) {
+  uint64_t deadline =
+      timer->_deadline > _wheel_time ? timer->_deadline : _wheel_time;
+  uint64_t delta = deadline - _wheel_time;
+
+  size_t level = 0;
+  while (level + 1 < _levels && delta >> (_slot_bits * (level + 1))) level++;
+
+  // beyond the top level's reach, wait in the slot it will empty last
+  if (delta >> (_slot_bits * _levels)) deadline = _wheel_time;
+
+  Timer **head = &_wheel[level][(deadline >> (_slot_bits * level)) &
+                                (_slots - 1)];
+  timer->_next = *head;
+  if (*head) (*head)->_link = &timer->_next;
+  *head = timer;
+  timer->_link = head;
+}
+
+/**
+ * @brief Takes a timer out of its slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param timer
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::unlink(Timer *timer) {
+  *timer->_link = timer->_next;
+  if (timer->_next) timer->_next->_link = timer->_link;
+}
+
+/**
+ * @brief Deletes an entry that is no longer in any slot
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param timer
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::remove(Timer *timer) {
+  _index.erase(timer->_key);
+  delete timer;
+}
+
+/**
+ * @brief Advances the wheel by one tick. Every level whose lower levels just
+ * completed a revolution moves its next slot down, then the entries in the
+ * new level 0 slot are deleted
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t the number of entries that expired
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t TTLHashMap<K, V, Hash, Pred>::turn() {
+  _wheel_time++;
+
+  for (size_t level = 1; level < _levels; level++) {
+    unsigned shift = _slot_bits * level;
+    if (_wheel_time & ((uint64_t(1) << shift) - 1)) break;
+
+    Timer **head = &_wheel[level][(_wheel_time >> shift) & (_slots - 1)];
+    Timer *timer = *head;
+    *head = nullptr;
+    while (timer) {
+      Timer *next = timer->_next;
+      schedule(timer);
+      timer = next;
+    }
+  }
+
+  size_t expired = 0;
+  Timer **head = &_wheel[0][_wheel_time & (_slots - 1)];
+  Timer *timer = *head;
+  *head = nullptr;
+  while (timer) {
+    Timer *next = timer->_next;
+    remove(timer);
+    expired++;
+    timer = next;
+  }
+
+  return expired;
+}
+
+/**
+ * @brief Construct an empty TTLHashMap with its clock at tick 0
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+TTLHashMap<K, V, Hash, Pred>::TTLHashMap()
+    : _now(0), _wheel_time(0), _wheel() {}
+
+/**
+ * @brief Destroy the TTLHashMap object
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+TTLHashMap<K, V, Hash, Pred>::~TTLHashMap() {
+  for (size_t level = 0; level < _levels; level++) {
+    for (size_t slot = 0; slot < _slots; slot++) {
+      Timer *timer = _wheel[level][slot];
+      while (timer) {
+        Timer *next = timer->_next;
+        delete timer;
+        timer = next;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Returns true if TTLHashMap is empty. Entries past their deadline
+ * count until a read or expire removes them
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool TTLHashMap<K, V, Hash, Pred>::is_empty() {
+  return _index.is_empty();
+}
+
+/**
+ * @brief Returns the number of entries, including any past their deadline
+ * that a read or expire has not removed yet
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t TTLHashMap<K, V, Hash, Pred>::size() {
+  return _index.size();
+}
+
+/**
+ * @brief Returns the current tick
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return uint64_t
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+uint64_t TTLHashMap<K, V, Hash, Pred>::now() {
+  return _now;
+}
+
+/**
+ * @brief Returns true if TTLHashMap contains the provided key and it has not
+ * expired
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return boolean
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+bool TTLHashMap<K, V, Hash, Pred>::has(const K &key) {
+  return find(key);
+}
+
+/**
+ * @brief Returns the value associated with the provided key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V&
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V &TTLHashMap<K, V, Hash, Pred>::get(const K &key) {
+  V *value = find(key);
+  if (!value) throw std::out_of_range("key not found");
+  return *value;
+}
+
+/**
+ * @brief Returns a pointer to the value associated with the provided key, or
+ * nullptr if it is absent. An entry found past its deadline is erased on the
+ * spot. The pointer is valid until the entry is replaced, erased or expired
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @return V*
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+V *TTLHashMap<K, V, Hash, Pred>::find(const K &key) {
+  Timer **found = _index.find(key);
+  if (!found) return nullptr;
+
+  Timer *timer = *found;
+  if (timer->_deadline <= _now) {
+    unlink(timer);
+    remove(timer);
+    return nullptr;
+  }
+  return &timer->_val;
+}
+
+/**
+ * @brief Insert or overwrite a key/value pair that expires ttl ticks from now.
+ * Overwriting a key replaces its deadline. A ttl of 0 erases the key
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ * @param value
+ * @param ttl
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::insert(const K &key, const V &value,
+                                          uint64_t ttl) {
+  if (!ttl) {
+    erase(key);
+    return;
+  }
+
+  Timer **found = _index.find(key);
+  if (found) {
+    Timer *timer = *found;
+    unlink(timer);
+    timer->_val = value;
+    timer->_deadline = _now + ttl;
+    schedule(timer);
+    return;
+  }
+
+  Timer *timer = new Timer(key, value, _now + ttl);
+  try {
+    _index.insert(key, timer);
+  } catch (...) {
+    delete timer;
+    throw;
+  }
+  schedule(timer);
+}
+
+/**
+ * @brief Delete a key/value pair
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param key
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::erase(const K &key) {
+  Timer **found = _index.find(key);
+  if (!found) return;
+
+  Timer *timer = *found;
+  unlink(timer);
+  remove(timer);
+}
+
+/**
+ * @brief Move the clock forward by ticks. This only records the time. Reads
+ * stop returning entries whose deadline has passed right away, and expire
+ * deletes them
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @param ticks
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+void TTLHashMap<K, V, Hash, Pred>::advance(uint64_t ticks) {
+  _now += ticks;
+}
+
+/**
+ * @brief Turn the wheel up to the current tick, deleting every entry whose
+ * deadline has passed. Call this once per tick, or as often as memory needs
+ * reclaiming. Once the map is empty, the wheel jumps straight to the clock
+ *
+ * @tparam K
+ * @tparam V
+ * @tparam Hash
+ * @tparam Pred
+ * @return size_t the number of entries deleted
+ */
+template <typename K, typename V, typename Hash, typename Pred>
+size_t TTLHashMap<K, V, Hash, Pred>::expire() {
+  size_t expired = 0;
+  while (_wheel_time < _now && !_index.is_empty()) expired += turn();
+  _wheel_time = _now;
+  return expired;
+}
@@ -4,24 +4,89 @@
 #include <string.h>
 
 #include <cstdlib>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "EmptyBase.h"
+#include "MallocAllocator.h"
+#include "VectorKernels.h"
+
+/**
+ * @brief Detects allocators with a reallocate(p, old_n, new_n) member that
+ * resizes storage in place where it can, like realloc
+ *
+ * @tparam A
+ */
+template <typename A, typename = void>
+class HasReallocate : public std::false_type {};
+
+template <typename A>
+class HasReallocate<
+    A, std::void_t<decltype(std::declval<A&>().reallocate(
+           std::declval<typename A::value_type*>(), size_t(), size_t()))> >
+    : public std::true_type {};
 
 /**
  * @brief A basic Vector class. I've made an effort to remain faithful to the
  * standard C++ Vector, but decided to scrap some things (e.g. push_front &
  * pop_front, as array-style storage is not conducive to these operations)
  *
+ * Elements are constructed in place and destroyed when removed, so any T
+ * works. Trivially copyable types are relocated with memcpy and shifted with
+ * memmove. Other types are moved element by element when their move
+ * constructor cannot throw, and copied otherwise, so a failed reallocation
+ * leaves the Vector unchanged.
+ *
+ * Storage comes from Alloc, which may be any standard allocator. The default
+ * MallocAllocator uses malloc and free. ArenaAllocator.h bumps short-lived
+ * vectors out of an arena, and HugePageAllocator.h gives large ones 64-byte
+ * aligned storage on huge pages. If Alloc also offers reallocate, a Vector of
+ * trivially copyable T resizes through it, so MallocAllocator can grow large
+ * buffers with mremap instead of copying them. Alloc is held as an empty
+ * base, so a stateless one like MallocAllocator adds nothing to the Vector.
+ *
+ * For arithmetic T, searching, reducing, filling and reversing run through the
+ * SIMD kernels in VectorKernels.h.
+ *
  * @tparam T
+ * @tparam Alloc
  */
-template <class T>
-class Vector {
+template <class T, class Alloc = MallocAllocator<T> >
+class Vector : private EmptyBase<Alloc> {
+  typedef std::allocator_traits<Alloc> AllocTraits;
+
   T* _data;
   size_t _size;
   size_t _capacity;
 
+  static const bool _trivial = std::is_trivially_copyable<T>::value;
+  static const bool _reallocate = _trivial && HasReallocate<Alloc>::value;
+  static const bool _simd = HasSimdKernels<T>::value;
+
   /**
-   * @brief Get new memory allocation, copy data, free previous memory
-   * allocation
+   * @brief Returns the allocator that storage comes from
+   */
+  Alloc& allocator();
+
+  /**
+   * @brief Move-construct n elements from src into the raw storage at dst,
+   * then destroy the originals. If a copy throws, the new elements are
+   * destroyed and src is left as it was
+   */
+  static void relocate(T*, T*, size_t);
+
+  /**
+   * @brief Destroy the elements in [first, last)
+   */
+  static void destroy(T*, T*);
+
+  /**
+   * @brief Get new memory allocation, move data, free previous memory
+   * allocation. Elements past the new capacity are destroyed. Trivially
+   * copyable elements are resized in place when Alloc supports it
    */
   void reallocate_storage(size_t);
 
@@ -35,12 +100,29 @@ class Vector {
    */
   void decrease_capacity();
 
+ protected:
+  /**
+   * @brief Exchange storage, size and capacity with v, but keep each Vector's
+   * allocator. Each allocator must be able to free the other's storage
+   *
+   * @param v Vector<T>
+   */
+  void swap_storage(Vector&) noexcept;
+
  public:
   /**
    * @brief Default Constructor: get Vector of size 0, capacity 0
    */
   Vector();
 
+  /**
+   * @brief Allocator Constructor: get Vector of size 0, capacity 0, whose
+   * storage will come from alloc
+   *
+   * @param alloc Alloc
+   */
+  explicit Vector(const Alloc&);
+
   /**
    * @brief Sized Constructor: get Vector  of size k, capacity k
    *
@@ -57,6 +139,25 @@ class Vector {
    */
   Vector(size_t, T);
 
+  Vector(const Vector&) = delete;
+  Vector& operator=(const Vector&) = delete;
+
+  /**
+   * @brief Move Constructor: take other's storage, leaving it empty
+   *
+   * @param other Vector<T>
+   */
+  Vector(Vector&&) noexcept;
+
+  /**
+   * @brief Move Assignment: free this Vector's storage and take other's,
+   * leaving it empty
+   *
+   * @param other Vector<T>
+   * @return Vector<T>&
+   */
+  Vector& operator=(Vector&&) noexcept;
+
   /**
    * @brief Destroy the Vector object
    */
@@ -82,8 +183,8 @@ class Vector {
   /**
    * @brief Resizes the vector to k elements. If k is less than size, any
    * element of index >= k will be deleted. If k is greater than size, then new
-   * elements will be 0 initialized (as by calloc). If k is also greater than
-   * capacity, then capacity will be k.
+   * elements will be value-initialized (0 for arithmetic types). If k is also
+   * greater than capacity, then capacity will be k.
    *
    * @param k size_t - The desired size
    */
@@ -98,7 +199,7 @@ class Vector {
    * @param k size_t - The desired size
    * @param val T - New elements initialized to val
    */
-  void resize(size_t, T);
+  void resize(size_t, const T&);
 
   /**
    * @brief Increase the capacity of the vector to k. If k < capacity, this does
@@ -121,14 +222,39 @@ class Vector {
   bool is_empty();
 
   /**
-   * @brief Get value at index
+   * @brief Get a reference to the value at index
    *
    * @param index size_t
    *
-   * @return T
+   * @return T&
    * @throws out-of-bounds if index < 0 or index >= size
    */
-  T at(size_t);
+  T& at(size_t);
+
+  /**
+   * @brief Get a reference to the value at index, without bounds checking
+   *
+   * @param index size_t
+   *
+   * @return T&
+   */
+  T& operator[](size_t);
+
+  /**
+   * @brief Get a reference to the first value
+   *
+   * @return T&
+   * @throws out-of-bounds if size == 0
+   */
+  T& front();
+
+  /**
+   * @brief Get a reference to the last value
+   *
+   * @return T&
+   * @throws out-of-bounds if size == 0
+   */
+  T& back();
 
   /**
    * @brief Returns a pointer to the vector's internal storage. Beware that if
@@ -146,7 +272,8 @@ class Vector {
    *
    * @throws out-of-bounds if index < 0 or index >= size
    */
-  void assign(size_t, T);
+  void assign(size_t, const T&);
+  void assign(size_t, T&&);
 
   /**
    * @brief Insert value at index. All elements to the right of index (and
@@ -157,7 +284,20 @@ class Vector {
    *
    * @throws out-of-bounds if index < 0 or index > size
    */
-  void insert(size_t, T);
+  void insert(size_t, const T&);
+  void insert(size_t, T&&);
+
+  /**
+   * @brief Construct a value in place at index from args. All elements to the
+   * right of index (and including index) are shifted right by one.
+   *
+   * @param index size_t
+   * @param args forwarded to T's constructor
+   *
+   * @throws out-of-bounds if index < 0 or index > size
+   */
+  template <class... Args>
+  void emplace(size_t, Args&&...);
 
   /**
    * @brief Remove value at index. All elements to the right of index are
@@ -165,7 +305,7 @@ class Vector {
    *
    * @param index size_t
    *
-   * @return T
+   * @return T the removed value, moved out of storage
    *
    * @throws out-of-bounds if index < 0 or index >= size
    */
@@ -176,7 +316,18 @@ class Vector {
    *
    * @param value T
    */
-  void push(T);
+  void push(const T&);
+  void push_back(const T&);
+  void push_back(T&&);
+
+  /**
+   * @brief Construct a value in place at the end of the vector from args
+   *
+   * @param args forwarded to T's constructor
+   * @return T& the new value
+   */
+  template <class... Args>
+  T& emplace_back(Args&&...);
 
   /**
    * @brief Pop a value from storage, removing it from the end of the vector
@@ -187,15 +338,66 @@ class Vector {
    */
   T pop();
 
+  /**
+   * @brief Destroy the value at the end of the vector
+   *
+   * @throws out-of-bounds if size == 0
+   */
+  void pop_back();
+
   /**
    * @brief Returns the index of the first matching value as defined by the
    * predicate f. Returns -1 if no matching value is found.
    *
-   * @param f a function that consumes a single param of type T, and which
-   * returns a bool
+   * @param f any callable that takes a T and returns a bool, such as a lambda,
+   * which the compiler can inline
+   * @return size_t
+   */
+  template <class F>
+  size_t index_of(F&&);
+
+  /**
+   * @brief Returns the index of the first value equal to val. Returns -1 if
+   * no value matches.
+   *
+   * @param val T
    * @return size_t
    */
-  size_t index_of(bool (*f)(T));
+  size_t find(const T&);
+
+  /**
+   * @brief Returns the number of values equal to val
+   *
+   * @param val T
+   * @return size_t
+   */
+  size_t count(const T&);
+
+  /**
+   * @brief Returns the smallest value. If the values include NaN, the result
+   * is unspecified
+   *
+   * @return T
+   * @throws invalid_argument if size == 0
+   */
+  T min();
+
+  /**
+   * @brief Returns the largest value. If the values include NaN, the result
+   * is unspecified
+   *
+   * @return T
+   * @throws invalid_argument if size == 0
+   */
+  T max();
+
+  /**
+   * @brief Returns the sum of all values, or T() if the vector is empty.
+   * Floating-point values may be added in any order
+   *
+   * @return T
+   */
+  T sum();
 
   /**
    * @brief Reverses the vector's internal storage in place
@@ -205,225 +407,419 @@ class Vector {
   /**
    * @brief Swap data with another Vector<T>
    *
-   * @param v Vector<T>
+   * @param v Vector<T>. Allocators are swapped along with the storage
    */
-  void swap(Vector<T>&);
+  void swap(Vector&);
 
   /**
    * @brief set size & capacity of Vector to 0 and free all allocated storage
    */
   void clear();
+
+  /**
+   * @brief Returns a copy of the allocator
+   *
+   * @return Alloc
+   */
+  Alloc get_allocator();
 };
 
-template <class T>
-void Vector<T>::reallocate_storage(size_t k) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::relocate(T* dst, T* src, size_t n) {
+  if constexpr (_trivial) {
+    if (n) memcpy(dst, src, n * sizeof(T));
+  } else {
+    size_t i = 0;
+    try {
+      for (; i < n; i++) new (dst + i) T(std::move_if_noexcept(src[i]));
+    } catch (...) {
+      destroy(dst, dst + i);
+      throw;
+    }
+    destroy(src, src + n);
+  }
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::destroy(T* first, T* last) {
+  if constexpr (!std::is_trivially_destructible<T>::value) {
+    for (; first != last; first++) first->~T();
+  } else {
+    (void)first;
+    (void)last;
+  }
+}
+
+template <class T, class Alloc>
+Alloc& Vector<T, Alloc>::allocator() {
+  return EmptyBase<Alloc>::get();
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::reallocate_storage(size_t k) {
   if (k == 0) {
+    destroy(_data, _data + _size);
+    if (_data) AllocTraits::deallocate(allocator(), _data, _capacity);
+
     _size = 0;
     _capacity = 0;
-
-    free(_data);
     _data = NULL;
   } else {
     if (k < _size) {
+      destroy(_data + k, _data + _size);
       _size = k;
     }
-    _capacity = k;
 
-    T* new_data = (T*)malloc(_capacity * sizeof(T));
-    memcpy(new_data, _data, _size * sizeof(T));
+    if constexpr (_reallocate) {
+      if (_data) {
+        _data = allocator().reallocate(_data, _capacity, k);
+        _capacity = k;
+        return;
+      }
+    }
+
+    T* new_data = AllocTraits::allocate(allocator(), k);
+    try {
+      relocate(new_data, _data, _size);
+    } catch (...) {
+      AllocTraits::deallocate(allocator(), new_data, k);
+      throw;
+    }
 
-    free(_data);
+    if (_data) AllocTraits::deallocate(allocator(), _data, _capacity);
     _data = new_data;
+    _capacity = k;
   }
 }
 
-template <class T>
-void Vector<T>::increase_capacity() {
+template <class T, class Alloc>
+void Vector<T, Alloc>::increase_capacity() {
   size_t new_capacity = _capacity == 0 ? 1 : _capacity * 2;
   reallocate_storage(new_capacity);
 }
 
-template <class T>
-void Vector<T>::decrease_capacity() {
+template <class T, class Alloc>
+void Vector<T, Alloc>::decrease_capacity() {
   if (_capacity == 0) return;
   size_t new_capacity = _capacity / 2;
   reallocate_storage(new_capacity);
 }
 
-template <class T>
-Vector<T>::Vector() {
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector() : EmptyBase<Alloc>() {
   _size = 0;
   _capacity = 0;
   _data = NULL;
 }
 
-template <class T>
-Vector<T>::Vector(size_t k) {
-  _size = k;
-  _capacity = k;
-  _data = (T*)calloc(k, sizeof(T));
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(const Alloc& alloc) : EmptyBase<Alloc>(alloc) {
+  _size = 0;
+  _capacity = 0;
+  _data = NULL;
 }
 
-template <class T>
-Vector<T>::Vector(size_t k, T val) {
-  _size = k;
-  _capacity = k;
-  _data = (T*)malloc(_capacity * sizeof(T));
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(size_t k) : Vector() {
+  resize(k);
+}
 
-  for (size_t i = 0; i < _size; i++) {
-    *(_data + i) = val;
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(size_t k, T val) : Vector() {
+  resize(k, val);
+}
+
+template <class T, class Alloc>
+Vector<T, Alloc>::Vector(Vector&& other) noexcept
+    : EmptyBase<Alloc>(other.allocator()) {
+  _size = other._size;
+  _capacity = other._capacity;
+  _data = other._data;
+
+  other._size = 0;
+  other._capacity = 0;
+  other._data = NULL;
+}
+
+template <class T, class Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(Vector&& other) noexcept {
+  if (this != &other) {
+    clear();
+    swap(other);
   }
+  return *this;
 }
 
-template <class T>
-Vector<T>::~Vector() {
-  free(_data);
+template <class T, class Alloc>
+Vector<T, Alloc>::~Vector() {
+  destroy(_data, _data + _size);
+  if (_data) AllocTraits::deallocate(allocator(), _data, _capacity);
 }
 
-template <class T>
-size_t Vector<T>::size() {
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::size() {
   return _size;
 }
 
-template <class T>
-size_t Vector<T>::capacity() {
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::capacity() {
   return _capacity;
 }
 
-template <class T>
-void Vector<T>::resize(size_t k) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::resize(size_t k) {
   if (k > _capacity) {
     reallocate_storage(k);
   }
 
   if (k > _size) {
-    memset(_data + _size, 0, (k - _size) * sizeof(T));
+    if constexpr (_simd) {
+      VectorKernels<T>::fill(_data + _size, k - _size, T());
+      _size = k;
+    } else {
+      for (; _size < k; _size++) new (_data + _size) T();
+    }
+  } else {
+    destroy(_data + k, _data + _size);
+    _size = k;
   }
-
-  _size = k;
 }
 
-template <class T>
-void Vector<T>::resize(size_t k, T val) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::resize(size_t k, const T& val) {
   if (k > _capacity) {
+    // val may live in the storage being replaced
+    T copy(val);
     reallocate_storage(k);
+    resize(k, copy);
+    return;
   }
 
   if (k > _size) {
-    for (size_t i = _size; i < k; i++) {
-      *(_data + i) = val;
+    if constexpr (_simd) {
+      VectorKernels<T>::fill(_data + _size, k - _size, val);
+      _size = k;
+    } else {
+      for (; _size < k; _size++) new (_data + _size) T(val);
     }
+  } else {
+    destroy(_data + k, _data + _size);
+    _size = k;
   }
-
-  _size = k;
 }
 
-template <class T>
-void Vector<T>::reserve(size_t k) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::reserve(size_t k) {
   if (k > _capacity) reallocate_storage(k);
 }
 
-template <class T>
-void Vector<T>::shrink_to_fit() {
+template <class T, class Alloc>
+void Vector<T, Alloc>::shrink_to_fit() {
   if (_capacity > _size) reallocate_storage(_size);
 }
 
-template <class T>
-bool Vector<T>::is_empty() {
+template <class T, class Alloc>
+bool Vector<T, Alloc>::is_empty() {
   return _size == 0;
 }
 
-template <class T>
-T Vector<T>::at(size_t i) {
+template <class T, class Alloc>
+T& Vector<T, Alloc>::at(size_t i) {
   if (i >= _size) throw std::invalid_argument("index out of bounds");
   return *(_data + i);
 }
 
-template <class T>
-T* Vector<T>::data() {
+template <class T, class Alloc>
+T& Vector<T, Alloc>::operator[](size_t i) {
+  return *(_data + i);
+}
+
+template <class T, class Alloc>
+T& Vector<T, Alloc>::front() {
+  return at(0);
+}
+
+template <class T, class Alloc>
+T& Vector<T, Alloc>::back() {
+  return at(_size - 1);
+}
+
+template <class T, class Alloc>
+T* Vector<T, Alloc>::data() {
   return _data;
 }
 
-template <class T>
-void Vector<T>::assign(size_t i, T val) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::assign(size_t i, const T& val) {
   if (i >= _size) throw std::invalid_argument("index out of bounds");
   *(_data + i) = val;
 }
 
-template <class T>
-void Vector<T>::insert(size_t i, T val) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::assign(size_t i, T&& val) {
+  if (i >= _size) throw std::invalid_argument("index out of bounds");
+  *(_data + i) = std::move(val);
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::insert(size_t i, const T& val) {
+  emplace(i, val);
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::insert(size_t i, T&& val) {
+  emplace(i, std::move(val));
+}
+
+template <class T, class Alloc>
+template <class... Args>
+void Vector<T, Alloc>::emplace(size_t i, Args&&... args) {
   if (i > _size) throw std::invalid_argument("index out of bounds");
+  if (i == _size) {
+    emplace_back(std::forward<Args>(args)...);
+    return;
+  }
+
+  // args may refer to an element that is about to move
+  T val(std::forward<Args>(args)...);
 
   if (_size == _capacity) increase_capacity();
 
-  memmove(_data + i + 1, _data + i, (_size - i) * sizeof(T));
-  *(_data + i) = val;
+  if constexpr (_trivial) {
+    memmove(_data + i + 1, _data + i, (_size - i) * sizeof(T));
+    new (_data + i) T(std::move(val));
+  } else {
+    new (_data + _size) T(std::move(*(_data + _size - 1)));
+    for (size_t j = _size - 1; j > i; j--) {
+      *(_data + j) = std::move(*(_data + j - 1));
+    }
+    *(_data + i) = std::move(val);
+  }
   _size++;
 }
 
-template <class T>
-T Vector<T>::remove(size_t i) {
+template <class T, class Alloc>
+T Vector<T, Alloc>::remove(size_t i) {
   if (i >= _size) throw std::invalid_argument("index out of bounds");
 
-  T val = *(_data + i);
-  memmove(_data + i, _data + i + 1, (_size - i - 1) * sizeof(T));
+  T val(std::move(*(_data + i)));
+  if constexpr (_trivial) {
+    memmove(_data + i, _data + i + 1, (_size - i - 1) * sizeof(T));
+  } else {
+    for (size_t j = i; j + 1 < _size; j++) {
+      *(_data + j) = std::move(*(_data + j + 1));
+    }
+    (_data + _size - 1)->~T();
+  }
   _size--;
 
   return val;
 }
 
-template <class T>
-void Vector<T>::push(T val) {
-  insert(_size, val);
+template <class T, class Alloc>
+void Vector<T, Alloc>::push(const T& val) {
+  emplace_back(val);
 }
 
-template <class T>
-T Vector<T>::pop() {
+template <class T, class Alloc>
+void Vector<T, Alloc>::push_back(const T& val) {
+  emplace_back(val);
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::push_back(T&& val) {
+  emplace_back(std::move(val));
+}
+
+template <class T, class Alloc>
+template <class... Args>
+T& Vector<T, Alloc>::emplace_back(Args&&... args) {
+  if (_size == _capacity) {
+    // args may refer to an element of the storage being replaced
+    T val(std::forward<Args>(args)...);
+    increase_capacity();
+    new (_data + _size) T(std::move(val));
+  } else {
+    new (_data + _size) T(std::forward<Args>(args)...);
+  }
+  return *(_data + _size++);
+}
+
+template <class T, class Alloc>
+T Vector<T, Alloc>::pop() {
   return remove(_size - 1);
 }
 
-template <class T>
-size_t Vector<T>::index_of(bool (*f)(T)) {
+template <class T, class Alloc>
+void Vector<T, Alloc>::pop_back() {
+  if (_size == 0) throw std::invalid_argument("index out of bounds");
+  _size--;
+  destroy(_data + _size, _data + _size + 1);
+}
+
+template <class T, class Alloc>
+template <class F>
+size_t Vector<T, Alloc>::index_of(F&& f) {
   for (size_t i = 0; i < _size; i++) {
-    if ((*f)(*(_data + i))) {
+    if (f(*(_data + i))) {
       return i;
     }
   }
   return -1;
 }
 
-template <class T>
-void Vector<T>::reverse() {
-  T *i, *j, temp;
-  i = _data;
-  j = _data + _size - 1;
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::find(const T& val) {
+  size_t i = VectorKernels<T>::find(_data, _size, val);
+  return i == _size ? -1 : i;
+}
 
-  while (i < j) {
-    temp = *i;
-    *i = *j;
-    *j = temp;
+template <class T, class Alloc>
+size_t Vector<T, Alloc>::count(const T& val) {
+  return VectorKernels<T>::count(_data, _size, val);
+}
 
-    i++;
-    j--;
-  }
+template <class T, class Alloc>
+T Vector<T, Alloc>::min() {
+  if (_size == 0) throw std::invalid_argument("vector is empty");
+  return VectorKernels<T>::min(_data, _size);
 }
 
-template <class T>
-void Vector<T>::swap(Vector<T>& v) {
-  size_t temp_size = _size;
-  _size = v._size;
-  v._size = temp_size;
+template <class T, class Alloc>
+T Vector<T, Alloc>::max() {
+  if (_size == 0) throw std::invalid_argument("vector is empty");
+  return VectorKernels<T>::max(_data, _size);
+}
 
-  size_t temp_capacity = _capacity;
-  _capacity = v._capacity;
-  v._capacity = temp_capacity;
+template <class T, class Alloc>
+T Vector<T, Alloc>::sum() {
+  return VectorKernels<T>::sum(_data, _size);
+}
 
-  T* temp_data = _data;
-  _data = v._data;
-  v._data = temp_data;
+template <class T, class Alloc>
+void Vector<T, Alloc>::reverse() {
+  VectorKernels<T>::reverse(_data, _size);
 }
 
-template <class T>
-void Vector<T>::clear() {
+template <class T, class Alloc>
+void Vector<T, Alloc>::swap_storage(Vector& v) noexcept {
+  std::swap(_data, v._data);
+  std::swap(_size, v._size);
+  std::swap(_capacity, v._capacity);
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::swap(Vector& v) {
+  swap_storage(v);
+  std::swap(allocator(), v.allocator());
+}
+
+template <class T, class Alloc>
+void Vector<T, Alloc>::clear() {
   reallocate_storage(0);
 }
+
+template <class T, class Alloc>
+Alloc Vector<T, Alloc>::get_allocator() {
+  return allocator();
+}
@@ -0,0 +1,641 @@
+/**
+ * @file VectorKernels.h
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief SIMD kernels for linear scans over arrays of arithmetic values:
+ * find, count, min, max, sum, fill and reverse. Vector uses them for
+ * arithmetic element types, where a scalar loop would move one element per
+ * instruction.
+ *
+ * SimdKernels<T, W> holds the kernels for W-byte registers, written with
+ * GCC/Clang vector extensions so that one template serves every element type.
+ * VectorKernels<T> picks the widest width the CPU supports at runtime: 32-byte
+ * AVX2 registers if available, and 16-byte SSE2 (or NEON) registers otherwise.
+ * On compilers without vector extensions it falls back to scalar loops.
+ *
+ * Vector results match a scalar loop except where noted: min and max are
+ * unspecified if the data contains NaN, and a floating-point sum adds in a
+ * different order, so it may round differently.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_KERNELS_AVX2
+#endif
+
+/**
+ * @brief Whether VectorKernels<T> has SIMD kernels for T, rather than scalar
+ * loops. True for arithmetic types other than bool and long double, on
+ * compilers with vector extensions
+ *
+ * @tparam T
+ */
+template <typename T>
+class HasSimdKernels
+    : public std::integral_constant<
+          bool,
+#if defined(__GNUC__)
+          std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+              sizeof(T) <= 8
+#else
+          false
+#endif
+          > {
+};
+
+#if defined(__GNUC__)
+
+#define SIMD_KERNEL inline __attribute__((always_inline))
+
+template <typename T, size_t W>
+class SimdKernels {
+  static_assert(HasSimdKernels<T>::value, "T must be a plain arithmetic type");
+
+ private:
+  /* Typedefs */
+  // GCC ignores vector_size on a non-dependent type, so Word depends on T
+  typedef typename std::conditional<sizeof(T) != 0, uint64_t, T>::type Word;
+  typedef T Vec __attribute__((vector_size(W)));
+  typedef Word Words __attribute__((vector_size(W)));
+
+  /* Static Members */
+  static const size_t _lanes = W / sizeof(T);
+  // a lane of count's tally is a signed integer as wide as T
+  static const size_t _count_flush =
+      sizeof(T) == 8 ? SIZE_MAX : (size_t(1) << (8 * sizeof(T) - 1)) - 1;
+
+  /* Helpers */
+  template <size_t... I>
+  static SIMD_KERNEL void reverse_lanes(T *, const T *,
+                                        std::index_sequence<I...>);
+
+ public:
+  /* Accessors */
+  static SIMD_KERNEL size_t find(const T *, size_t, T);
+  static SIMD_KERNEL size_t count(const T *, size_t, T);
+  static SIMD_KERNEL T min(const T *, size_t);
+  static SIMD_KERNEL T max(const T *, size_t);
+  static SIMD_KERNEL T sum(const T *, size_t);
+
+  /* Mutators */
+  static SIMD_KERNEL void fill(T *, size_t, T);
+  static SIMD_KERNEL void reverse(T *, size_t);
+};
+
+#endif
+
+template <typename T>
+class VectorKernels {
+#if defined(VECTOR_KERNELS_AVX2)
+ private:
+  /* Helpers */
+  static bool has_avx2();
+  static size_t find_avx2(const T *, size_t, T);
+  static size_t count_avx2(const T *, size_t, T);
+  static T min_avx2(const T *, size_t);
+  static T max_avx2(const T *, size_t);
+  static T sum_avx2(const T *, size_t);
+  static void fill_avx2(T *, size_t, T);
+  static void reverse_avx2(T *, size_t);
+#endif
+
+ public:
+  /* Accessors */
+  static size_t find(const T *, size_t, const T &);
+  static size_t count(const T *, size_t, const T &);
+  static T min(const T *, size_t);
+  static T max(const T *, size_t);
+  static T sum(const T *, size_t);
+
+  /* Mutators */
+  static void fill(T *, size_t, const T &);
+  static void reverse(T *, size_t);
+};
+
+#if defined(__GNUC__)
+
+/**
+ * @brief Stores the lanes of the W bytes at src into dst in reverse order
+ *
+ * @tparam T
+ * @tparam W
+ * @tparam I 0 to _lanes - 1
+ * @param dst
+ * @param src
+ */
+template <typename T, size_t W>
+template <size_t... I>
+void SimdKernels<T, W>::reverse_lanes(T *dst, const T *src,
+                                      std::index_sequence<I...>) {
+  Vec v;
+  __builtin_memcpy(&v, src, W);
+#if defined(__clang__)
+  v = __builtin_shufflevector(v, v, (_lanes - 1 - I)...);
+#else
+  typedef decltype(v == v) Mask;
+  v = __builtin_shuffle(v, Mask{(_lanes - 1 - I)...});
+#endif
+  __builtin_memcpy(dst, &v, W);
+}
+
+/**
+ * @brief Returns the index of the first element equal to value, or n if there
+ * is none. Each register of elements is compared at once, and only a register
+ * with a match is scanned element by element
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T, size_t W>
+size_t SimdKernels<T, W>::find(const T *p, size_t n, T value) {
+  Vec needle = Vec{} + value;
+  size_t i = 0;
+
+  for (; i + _lanes <= n; i += _lanes) {
+    Vec v;
+    __builtin_memcpy(&v, p + i, W);
+    Words match = (Words)(v == needle);
+
+    uint64_t any = 0;
+    for (size_t k = 0; k < W / 8; k++) any |= match[k];
+    if (any) break;
+  }
+
+  for (; i < n; i++) {
+    if (p[i] == value) return i;
+  }
+  return n;
+}
+
+/**
+ * @brief Returns the number of elements equal to value. Matches are tallied
+ * per lane, and lanes narrower than 64 bits are flushed before they can
+ * overflow
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T, size_t W>
+size_t SimdKernels<T, W>::count(const T *p, size_t n, T value) {
+  typedef decltype(Vec{} == Vec{}) Mask;
+
+  Vec needle = Vec{} + value;
+  size_t total = 0;
+  size_t i = 0;
+
+  while (i + _lanes <= n) {
+    Mask tally = {};
+    for (size_t r = 0; r < _count_flush && i + _lanes <= n; r++) {
+      Vec v;
+      __builtin_memcpy(&v, p + i, W);
+      tally -= v == needle;
+      i += _lanes;
+    }
+    for (size_t k = 0; k < _lanes; k++) total += size_t(tally[k]);
+  }
+
+  for (; i < n; i++) total += p[i] == value;
+  return total;
+}
+
+/**
+ * @brief Returns the smallest element. n must be at least 1
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T, size_t W>
+T SimdKernels<T, W>::min(const T *p, size_t n) {
+  T best = p[0];
+  size_t i = 0;
+
+  if (n >= _lanes) {
+    Vec lowest;
+    __builtin_memcpy(&lowest, p, W);
+    for (i = _lanes; i + _lanes <= n; i += _lanes) {
+      Vec v;
+      __builtin_memcpy(&v, p + i, W);
+      lowest = v < lowest ? v : lowest;
+    }
+    for (size_t k = 0; k < _lanes; k++) {
+      if (lowest[k] < best) best = lowest[k];
+    }
+  }
+
+  for (; i < n; i++) {
+    if (p[i] < best) best = p[i];
+  }
+  return best;
+}
+
+/**
+ * @brief Returns the largest element. n must be at least 1
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T, size_t W>
+T SimdKernels<T, W>::max(const T *p, size_t n) {
+  T best = p[0];
+  size_t i = 0;
+
+  if (n >= _lanes) {
+    Vec highest;
+    __builtin_memcpy(&highest, p, W);
+    for (i = _lanes; i + _lanes <= n; i += _lanes) {
+      Vec v;
+      __builtin_memcpy(&v, p + i, W);
+      highest = v > highest ? v : highest;
+    }
+    for (size_t k = 0; k < _lanes; k++) {
+      if (highest[k] > best) best = highest[k];
+    }
+  }
+
+  for (; i < n; i++) {
+    if (p[i] > best) best = p[i];
+  }
+  return best;
+}
+
+/**
+ * @brief Returns the sum of the elements, or 0 if n is 0. The sum must fit in
+ * T, as it would for a scalar loop
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T, size_t W>
+T SimdKernels<T, W>::sum(const T *p, size_t n) {
+  Vec partial = {};
+  size_t i = 0;
+
+  for (; i + _lanes <= n; i += _lanes) {
+    Vec v;
+    __builtin_memcpy(&v, p + i, W);
+    partial += v;
+  }
+
+  T total = 0;
+  for (size_t k = 0; k < _lanes; k++) total += partial[k];
+  for (; i < n; i++) total += p[i];
+  return total;
+}
+
+/**
+ * @brief Sets the n elements at p to value. p may be uninitialized storage
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ * @param value
+ */
+template <typename T, size_t W>
+void SimdKernels<T, W>::fill(T *p, size_t n, T value) {
+  Vec v = Vec{} + value;
+  size_t i = 0;
+
+  for (; i + _lanes <= n; i += _lanes) __builtin_memcpy(p + i, &v, W);
+  for (; i < n; i++) p[i] = value;
+}
+
+/**
+ * @brief Reverses the n elements at p in place. A register is taken from each
+ * end, its lanes reversed, and the two stored at the opposite ends
+ *
+ * @tparam T
+ * @tparam W
+ * @param p
+ * @param n
+ */
+template <typename T, size_t W>
+void SimdKernels<T, W>::reverse(T *p, size_t n) {
+  size_t i = 0;
+  size_t j = n;
+
+  for (; j - i >= 2 * _lanes; i += _lanes, j -= _lanes) {
+    T front[_lanes];
+    reverse_lanes(front, p + i, std::make_index_sequence<_lanes>());
+    reverse_lanes(p + i, p + j - _lanes, std::make_index_sequence<_lanes>());
+    __builtin_memcpy(p + j - _lanes, front, W);
+  }
+
+  for (; i + 1 < j; i++, j--) {
+    T temp = p[i];
+    p[i] = p[j - 1];
+    p[j - 1] = temp;
+  }
+}
+
+#undef SIMD_KERNEL
+
+#endif
+
+#if defined(VECTOR_KERNELS_AVX2)
+
+#define AVX2_KERNEL __attribute__((target("avx2")))
+
+/**
+ * @brief Returns true if the CPU supports AVX2. The answer is looked up once
+ * and cached
+ *
+ * @tparam T
+ * @return bool
+ */
+template <typename T>
+bool VectorKernels<T>::has_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+
+/**
+ * @brief find, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T>
+AVX2_KERNEL size_t VectorKernels<T>::find_avx2(const T *p, size_t n, T value) {
+  return SimdKernels<T, 32>::find(p, n, value);
+}
+
+/**
+ * @brief count, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T>
+AVX2_KERNEL size_t VectorKernels<T>::count_avx2(const T *p, size_t n,
+                                                T value) {
+  return SimdKernels<T, 32>::count(p, n, value);
+}
+
+/**
+ * @brief min, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+AVX2_KERNEL T VectorKernels<T>::min_avx2(const T *p, size_t n) {
+  return SimdKernels<T, 32>::min(p, n);
+}
+
+/**
+ * @brief max, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+AVX2_KERNEL T VectorKernels<T>::max_avx2(const T *p, size_t n) {
+  return SimdKernels<T, 32>::max(p, n);
+}
+
+/**
+ * @brief sum, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+AVX2_KERNEL T VectorKernels<T>::sum_avx2(const T *p, size_t n) {
+  return SimdKernels<T, 32>::sum(p, n);
+}
+
+/**
+ * @brief fill, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ */
+template <typename T>
+AVX2_KERNEL void VectorKernels<T>::fill_avx2(T *p, size_t n, T value) {
+  SimdKernels<T, 32>::fill(p, n, value);
+}
+
+/**
+ * @brief reverse, compiled for AVX2
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ */
+template <typename T>
+AVX2_KERNEL void VectorKernels<T>::reverse_avx2(T *p, size_t n) {
+  SimdKernels<T, 32>::reverse(p, n);
+}
+
+#undef AVX2_KERNEL
+
+#endif
+
+/**
+ * @brief Returns the index of the first of the n elements at p that equals
+ * value, or n if there is none
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T>
+size_t VectorKernels<T>::find(const T *p, size_t n, const T &value) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return find_avx2(p, n, value);
+#endif
+    return SimdKernels<T, 16>::find(p, n, value);
+  }
+#endif
+  for (size_t i = 0; i < n; i++) {
+    if (p[i] == value) return i;
+  }
+  return n;
+}
+
+/**
+ * @brief Returns how many of the n elements at p equal value
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ * @return size_t
+ */
+template <typename T>
+size_t VectorKernels<T>::count(const T *p, size_t n, const T &value) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return count_avx2(p, n, value);
+#endif
+    return SimdKernels<T, 16>::count(p, n, value);
+  }
+#endif
+  size_t total = 0;
+  for (size_t i = 0; i < n; i++) total += p[i] == value;
+  return total;
+}
+
+/**
+ * @brief Returns the smallest of the n elements at p. n must be at least 1
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+T VectorKernels<T>::min(const T *p, size_t n) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return min_avx2(p, n);
+#endif
+    return SimdKernels<T, 16>::min(p, n);
+  }
+#endif
+  T best = p[0];
+  for (size_t i = 1; i < n; i++) {
+    if (p[i] < best) best = p[i];
+  }
+  return best;
+}
+
+/**
+ * @brief Returns the largest of the n elements at p. n must be at least 1
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+T VectorKernels<T>::max(const T *p, size_t n) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return max_avx2(p, n);
+#endif
+    return SimdKernels<T, 16>::max(p, n);
+  }
+#endif
+  T best = p[0];
+  for (size_t i = 1; i < n; i++) {
+    if (p[i] > best) best = p[i];
+  }
+  return best;
+}
+
+/**
+ * @brief Returns the sum of the n elements at p, or T() if n is 0
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @return T
+ */
+template <typename T>
+T VectorKernels<T>::sum(const T *p, size_t n) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return sum_avx2(p, n);
+#endif
+    return SimdKernels<T, 16>::sum(p, n);
+  }
+#endif
+  T total = T();
+  for (size_t i = 0; i < n; i++) total = total + p[i];
+  return total;
+}
+
+/**
+ * @brief Sets the n elements at p to value. For types with SIMD kernels, p may
+ * be uninitialized storage
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ * @param value
+ */
+template <typename T>
+void VectorKernels<T>::fill(T *p, size_t n, const T &value) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return fill_avx2(p, n, value);
+#endif
+    return SimdKernels<T, 16>::fill(p, n, value);
+  }
+#endif
+  for (size_t i = 0; i < n; i++) p[i] = value;
+}
+
+/**
+ * @brief Reverses the n elements at p in place
+ *
+ * @tparam T
+ * @param p
+ * @param n
+ */
+template <typename T>
+void VectorKernels<T>::reverse(T *p, size_t n) {
+#if defined(__GNUC__)
+  if constexpr (HasSimdKernels<T>::value) {
+#if defined(VECTOR_KERNELS_AVX2)
+    if (has_avx2()) return reverse_avx2(p, n);
+#endif
+    return SimdKernels<T, 16>::reverse(p, n);
+  }
+#endif
+  for (size_t i = 0; i + 1 < n - i; i++) std::swap(p[i], p[n - 1 - i]);
+}
+
+#undef VECTOR_KERNELS_AVX2
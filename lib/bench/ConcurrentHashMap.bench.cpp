@@ -0,0 +1,128 @@
+/**
+ * @file ConcurrentHashMap.bench.cpp
+ * @author Aubrey Nicoll (aubrey.nicoll@gmail.com)
+ * @brief Multi-threaded throughput of ConcurrentHashMap against a HashMap
+ * behind one global mutex. Every thread count from 1 up to the hardware
+ * concurrency runs a read-only phase and a 90% read / 10% write phase over a
+ * prefilled map, and reports millions of operations per second.
+ *
+ * Usage: ConcurrentHashMap [keys] [ops per thread]
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../ConcurrentHashMap.h"
+#include "../HashMapV1.h"
+
+class LockedHashMap {
+ public:
+  std::mutex _mutex;
+  HashMap<uint64_t, uint64_t> _map;
+
+  bool has(uint64_t key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _map.has(key);
+  }
+
+  void insert(uint64_t key, uint64_t value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _map.insert(key, value);
+  }
+};
+
+/**
+ * @brief A xorshift generator, so the benchmark loop does not measure
+ * std::mt19937
+ */
+static uint64_t next_random(uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+/**
+ * @brief Run ops operations on each of threads threads and return the
+ * aggregate throughput in millions of operations per second
+ */
+template <typename Map>
+static double run(Map &map, unsigned threads, uint64_t keys, uint64_t ops,
+                  unsigned write_percent) {
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> found(threads);
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      uint64_t state = 0x9E3779B97F4A7C15ULL * (t + 1);
+      uint64_t hits = 0;
+
+      for (uint64_t i = 0; i < ops; i++) {
+        uint64_t r = next_random(state);
+        uint64_t key = r % (2 * keys);  // half of the lookups miss
+
+        if (r >> 57 < write_percent * 128 / 100) {
+          map.insert(key, i);
+        } else {
+          hits += map.has(key);
+        }
+      }
+
+      found[t] = hits;
+    });
+  }
+
+  for (std::thread &worker : workers) worker.join();
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return double(threads) * double(ops) / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+  uint64_t keys = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1 << 20;
+  uint64_t ops = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1 << 22;
+  unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+
+  printf("%-8s %-10s %16s %16s\n", "threads", "workload", "global mutex",
+         "concurrent");
+
+  // powers of two, then max_threads itself if it is not one
+  for (unsigned threads = 1; threads <= max_threads;
+       threads = threads < max_threads && threads * 2 > max_threads
+                     ? max_threads
+                     : threads * 2) {
+    for (unsigned write_percent : {0U, 10U}) {
+      LockedHashMap locked;
+      ConcurrentHashMap<uint64_t, uint64_t> concurrent;
+
+      for (uint64_t key = 0; key < keys; key++) {
+        locked.insert(key, key);
+        concurrent.insert(key, key);
+      }
+
+      double locked_mops = run(locked, threads, keys, ops, write_percent);
+      double concurrent_mops =
+          run(concurrent, threads, keys, ops, write_percent);
+
+      printf("%-8u %3u%% write %11.2f Mop/s %11.2f Mop/s\n", threads,
+             write_percent, locked_mops, concurrent_mops);
+    }
+  }
+
+  return 0;
+}
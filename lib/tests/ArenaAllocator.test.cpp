@@ -0,0 +1,83 @@
+#include "../ArenaAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "../Vector.h"
+
+TEST(ArenaAllocatorTest, BumpsWithinABlock) {
+  Arena arena(1024);
+  ArenaAllocator<int> alloc(arena);
+
+  int *a = alloc.allocate(4);
+  int *b = alloc.allocate(4);
+  EXPECT_EQ(b, a + 4);
+  EXPECT_EQ(arena.bytes_allocated(), 32);
+
+  // only the most recent allocation is given back
+  alloc.deallocate(a, 4);
+  EXPECT_EQ(arena.bytes_allocated(), 32);
+  alloc.deallocate(b, 4);
+  EXPECT_EQ(arena.bytes_allocated(), 16);
+  EXPECT_EQ(alloc.allocate(4), b);
+
+  // larger than a block, and over-aligned
+  ArenaAllocator<double> rebound(alloc);
+  EXPECT_TRUE(rebound == alloc);
+  double *big = rebound.allocate(1000);
+  big[999] = 1;
+  void *aligned = arena.allocate(8, 256);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0);
+
+  arena.reset();
+  EXPECT_EQ(arena.bytes_allocated(), 0);
+
+  Arena other;
+  EXPECT_TRUE(ArenaAllocator<int>(other) != alloc);
+}
+
+TEST(ArenaAllocatorTest, ReallocatesTheLastAllocationInPlace) {
+  Arena arena(1024);
+  ArenaAllocator<int> alloc(arena);
+
+  int *a = alloc.allocate(4);
+  for (int i = 0; i < 4; i++) a[i] = i;
+  EXPECT_EQ(alloc.reallocate(a, 4, 64), a);
+  EXPECT_EQ(arena.bytes_allocated(), 256);
+
+  // a is no longer the most recent allocation, so it moves
+  int *b = alloc.allocate(4);
+  int *c = alloc.reallocate(a, 64, 128);
+  EXPECT_NE(c, a);
+  EXPECT_EQ(c[3], 3);
+  EXPECT_EQ(arena.bytes_allocated(), 256 + 16 + 512);
+
+  // past the end of the block, the last allocation moves too
+  int *d = alloc.reallocate(c, 128, 1024);
+  EXPECT_NE(d, c);
+  EXPECT_EQ(d[3], 3);
+  EXPECT_NE(b, d);
+}
+
+TEST(ArenaAllocatorTest, BacksVectors) {
+  Arena arena;
+
+  for (int request = 0; request < 10; request++) {
+    Vector<std::string, ArenaAllocator<std::string> > names(
+        (ArenaAllocator<std::string>(arena)));
+    Vector<int, ArenaAllocator<int> > ids((ArenaAllocator<int>(arena)));
+
+    for (int i = 0; i < 100; i++) {
+      names.push_back(std::to_string(i));
+      ids.push_back(i);
+    }
+    EXPECT_EQ(names.at(99), "99");
+    EXPECT_EQ(ids.at(99), 99);
+    EXPECT_TRUE(&names.get_allocator().arena() == &arena);
+  }
+
+  EXPECT_GT(arena.bytes_allocated(), 0);
+  arena.reset();
+}
@@ -0,0 +1,33 @@
+#include "../BloomFilter.h"
+
+#include <gtest/gtest.h>
+
+#include "../Hashing.h"
+
+TEST(BlockedBloomFilterTest, EmptyFilterPassesEverything) {
+  BlockedBloomFilter filter;
+  EXPECT_TRUE(filter.is_empty());
+  EXPECT_EQ(filter.bytes(), 0);
+  EXPECT_TRUE(filter.may_contain(mix_hash(1, 0)));
+
+  filter.reset(0, 10);
+  EXPECT_TRUE(filter.is_empty());
+}
+
+TEST(BlockedBloomFilterTest, NoFalseNegativesFewFalsePositives) {
+  BlockedBloomFilter filter;
+  filter.reset(10000, 10);
+  EXPECT_EQ(filter.bytes(), 196 * 64);
+
+  for (uint64_t i = 0; i < 10000; i++) filter.insert(mix_hash(i, 42));
+  for (uint64_t i = 0; i < 10000; i++)
+    EXPECT_TRUE(filter.may_contain(mix_hash(i, 42)));
+
+  int passed = 0;
+  for (uint64_t i = 10000; i < 110000; i++)
+    passed += filter.may_contain(mix_hash(i, 42));
+  EXPECT_LT(passed, 2000);
+
+  filter.clear();
+  EXPECT_TRUE(filter.is_empty());
+}
@@ -0,0 +1,129 @@
+#include "../Cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+TEST(LRUCacheTest, EvictsLeastRecentlyUsed) {
+  LRUCache<char, int> cache(3);
+
+  cache.put('a', 1);
+  cache.put('b', 2);
+  cache.put('c', 3);
+  EXPECT_EQ(*cache.find('a'), 1);
+
+  cache.put('d', 4);
+  EXPECT_FALSE(cache.has('b'));
+  EXPECT_EQ(cache.size(), 3);
+
+  cache.put('e', 5);
+  EXPECT_FALSE(cache.has('c'));
+  EXPECT_TRUE(cache.has('a'));
+  EXPECT_TRUE(cache.has('d'));
+  EXPECT_TRUE(cache.has('e'));
+
+  EXPECT_EQ(cache.find('b'), nullptr);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.evictions(), 2);
+}
+
+TEST(LRUCacheTest, OverwriteAndErase) {
+  LRUCache<int, int> cache(2);
+
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.put(1, 10);  // refreshes 1, so 2 is now the oldest
+  cache.put(3, 3);
+
+  EXPECT_EQ(*cache.find(1), 10);
+  EXPECT_FALSE(cache.has(2));
+
+  cache.erase(1);
+  cache.erase(1);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.evictions(), 1);
+}
+
+struct StringBytes {
+  size_t operator()(const int &, const std::string &value) const {
+    return value.size();
+  }
+};
+
+TEST(LRUCacheTest, ByteCapacity) {
+  LRUCache<int, std::string, std::hash<int>, std::equal_to<int>, StringBytes>
+      cache(10);
+
+  cache.put(1, "aaaa");
+  cache.put(2, "bbbb");
+  EXPECT_EQ(cache.weight(), 8);
+
+  // 6 more bytes only fit once the oldest entry is gone
+  cache.put(3, "cccccc");
+  EXPECT_FALSE(cache.has(1));
+  EXPECT_EQ(cache.weight(), 10);
+
+  // too big to ever fit
+  cache.put(4, "dddddddddddd");
+  EXPECT_FALSE(cache.has(4));
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(ClockCacheTest, GivesReferencedEntriesASecondChance) {
+  ClockCache<char, int> cache(3);
+
+  cache.put('a', 1);
+  cache.put('b', 2);
+  cache.put('c', 3);
+  EXPECT_EQ(*cache.find('a'), 1);
+
+  // the hand clears a's flag and evicts b
+  cache.put('d', 4);
+  EXPECT_TRUE(cache.has('a'));
+  EXPECT_FALSE(cache.has('b'));
+
+  // then c, which was never referenced
+  cache.put('e', 5);
+  EXPECT_FALSE(cache.has('c'));
+  EXPECT_TRUE(cache.has('a'));
+
+  EXPECT_EQ(cache.find('b'), nullptr);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(cache.evictions(), 2);
+}
+
+TEST(ClockCacheTest, ByteCapacity) {
+  ClockCache<int, std::string, std::hash<int>, std::equal_to<int>,
+             StringBytes>
+      cache(10);
+
+  for (int i = 0; i < 100; i++) {
+    cache.put(i, std::string(i % 5 + 1, 'x'));
+    ASSERT_LE(cache.weight(), 10);
+  }
+
+  // growing an entry evicts others, but never the entry itself
+  cache.put(99, std::string(10, 'y'));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(*cache.find(99), std::string(10, 'y'));
+}
+
+TEST(ClockCacheTest, DestroysRemovedEntries) {
+  ClockCache<int, std::shared_ptr<int>> cache(3);
+  std::shared_ptr<int> value = std::make_shared<int>(7);
+
+  cache.put(1, value);
+  cache.put(2, value);
+  cache.put(3, value);
+  EXPECT_EQ(value.use_count(), 4);
+
+  // evicted and erased entries let go of their values before their slots are
+  // reused
+  cache.put(4, nullptr);
+  EXPECT_EQ(value.use_count(), 3);
+  cache.erase(2);
+  EXPECT_EQ(value.use_count(), 2);
+}
@@ -0,0 +1,59 @@
+#include "../ConcurrentHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentHashMapTest, ShardCountIsPowerOfTwo) {
+  ConcurrentHashMap<int, int> map(5);
+  EXPECT_EQ(map.shard_count(), 8);
+  EXPECT_TRUE(map.is_empty());
+
+  ConcurrentHashMap<int, int> single(1);
+  EXPECT_EQ(single.shard_count(), 1);
+}
+
+TEST(ConcurrentHashMapTest, SingleThreadedSemantics) {
+  ConcurrentHashMap<char, int> map(4);
+
+  for (int i = 0; i < 26; i++) map.insert('a' + i, i);
+  map.insert('a', 100);
+
+  EXPECT_EQ(map.size(), 26);
+  EXPECT_EQ(map.get('a'), 100);
+  EXPECT_ANY_THROW(map.get('A'));
+
+  int value = 0;
+  EXPECT_TRUE(map.find('z', value));
+  EXPECT_EQ(value, 25);
+  EXPECT_FALSE(map.find('Z', value));
+
+  for (int i = 0; i < 26; i++) map.erase('a' + i);
+  EXPECT_TRUE(map.is_empty());
+  EXPECT_FALSE(map.has('a'));
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentWritersAndReaders) {
+  ConcurrentHashMap<int, int> map;
+  const int threads = 8;
+  const int per_thread = 5000;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&map, t]() {
+      for (int i = 0; i < per_thread; i++) {
+        int key = t * per_thread + i;
+        map.insert(key, key);
+        EXPECT_TRUE(map.has(key));
+        if (i % 2) map.erase(key);
+      }
+    });
+  }
+  for (std::thread &worker : workers) worker.join();
+
+  EXPECT_EQ(map.size(), threads * per_thread / 2);
+  for (int key = 0; key < threads * per_thread; key++) {
+    EXPECT_EQ(map.has(key), key % 2 == 0);
+  }
+}
@@ -0,0 +1,103 @@
+#include "../CuckooHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+TEST(CuckooHashMapTest, EmptyInitialization) {
+  CuckooHashMap<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.capacity(), 0);
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(CuckooHashMapTest, HandlesAlphabet) {
+  CuckooHashMap<char, int> map;
+
+  for (int i = 0; i < 26; i++) map.insert('a' + i, i);
+
+  EXPECT_EQ(map.size(), 26);
+  for (int i = 0; i < 26; i++) EXPECT_EQ(map.get('a' + i), i);
+
+  for (int i = 0; i < 26; i++) map.erase('a' + i);
+
+  EXPECT_TRUE(map.is_empty());
+  EXPECT_EQ(map.stash_size(), 0);
+  for (int i = 0; i < 26; i++) EXPECT_FALSE(map.has('a' + i));
+}
+
+TEST(CuckooHashMapTest, ManyKeys) {
+  CuckooHashMap<std::string, int> map;
+
+  for (int i = 0; i < 20000; i++) map.insert(std::to_string(i), i);
+  for (int i = 0; i < 20000; i += 2) map.erase(std::to_string(i));
+  for (int i = 0; i < 20000; i += 4) map.insert(std::to_string(i), -i);
+
+  EXPECT_EQ(map.size(), 15000);
+  EXPECT_LE(map.load_factor(), 0.95);
+  for (int i = 0; i < 20000; i++) {
+    if (i % 4 == 0) {
+      EXPECT_EQ(map.get(std::to_string(i)), -i);
+    } else if (i % 2 == 1) {
+      EXPECT_EQ(map.get(std::to_string(i)), i);
+    } else {
+      EXPECT_FALSE(map.has(std::to_string(i)));
+    }
+  }
+}
+
+struct NarrowHash {
+  size_t operator()(int key) const { return key % 12; }
+};
+
+TEST(CuckooHashMapTest, StashAndRehash) {
+  // 12 hash values give at most 24 candidate buckets however large the table
+  // is, so 60 keys keep evictions long and push entries into the stash
+  CuckooHashMap<int, int, NarrowHash> map;
+
+  for (int i = 0; i < 60; i++) map.insert(i, i);
+
+  EXPECT_EQ(map.size(), 60);
+  for (int i = 0; i < 60; i++) EXPECT_EQ(map.get(i), i);
+  for (int i = 0; i < 60; i += 2) map.erase(i);
+  for (int i = 0; i < 60; i++) EXPECT_EQ(map.has(i), i % 2 == 1);
+}
+
+struct ConstantHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(CuckooHashMapTest, TooManyCollisionsThrows) {
+  // two buckets of four plus the stash hold at most 12 keys with one hash
+  CuckooHashMap<int, int, ConstantHash> map;
+
+  for (int i = 0; i < 12; i++) map.insert(i, i);
+  EXPECT_THROW(map.insert(12, 12), std::overflow_error);
+
+  // only the key that did not fit is dropped
+  EXPECT_EQ(map.size(), 12);
+  EXPECT_FALSE(map.has(12));
+  for (int i = 0; i < 12; i++) EXPECT_EQ(map.get(i), i);
+
+  map.erase(0);
+  map.insert(12, 12);
+  for (int i = 1; i <= 12; i++) EXPECT_EQ(map.get(i), i);
+}
+
+TEST(CuckooHashMapTest, BucketWidthFitsACacheLine) {
+  // 16-byte entries fit three to a line, next to the occupancy byte
+  CuckooHashMap<uint64_t, uint64_t> map;
+  for (uint64_t i = 0; i < 10000; i++) map.insert(i, i * 3);
+
+  EXPECT_EQ(map.capacity() % 3, 0);
+  EXPECT_LE(map.load_factor(), 0.90);
+  for (uint64_t i = 0; i < 10000; i++) EXPECT_EQ(map.get(i), i * 3);
+
+  // entries larger than a line get one-way buckets
+  CuckooHashMap<std::string, std::string> wide;
+  for (int i = 0; i < 1000; i++) wide.insert(std::to_string(i), "x");
+  EXPECT_LE(wide.load_factor(), 0.45);
+  for (int i = 0; i < 1000; i++) EXPECT_TRUE(wide.has(std::to_string(i)));
+}
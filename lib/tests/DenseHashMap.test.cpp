@@ -0,0 +1,95 @@
+#include "../DenseHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(DenseHashMapTest, EmptyInitialization) {
+  DenseHashMap<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.capacity(), 0);
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(DenseHashMapTest, HandlesAlphabet) {
+  DenseHashMap<char, int> map;
+
+  for (int i = 0; i < 26; i++) map.insert('a' + i, i);
+
+  EXPECT_EQ(map.size(), 26);
+  EXPECT_EQ(map.capacity(), 64);
+  for (int i = 0; i < 26; i++) EXPECT_EQ(map.get('a' + i), i);
+
+  for (int i = 0; i < 26; i++) map.erase('a' + i);
+
+  EXPECT_TRUE(map.is_empty());
+  for (int i = 0; i < 26; i++) EXPECT_FALSE(map.has('a' + i));
+}
+
+TEST(DenseHashMapTest, IteratesInInsertionOrder) {
+  DenseHashMap<int, int> map;
+
+  for (int i = 0; i < 100; i++) map.insert(i * 31 % 100, i);
+  map.insert(0, -1);  // overwriting keeps the original position
+
+  std::vector<int> keys;
+  map.for_each([&](const int &key, int &) { keys.push_back(key); });
+
+  ASSERT_EQ(keys.size(), 100);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(keys[i], i * 31 % 100);
+  EXPECT_EQ(map.value_at(0), -1);
+}
+
+TEST(DenseHashMapTest, EraseSwapsInLastEntry) {
+  DenseHashMap<int, int> map;
+
+  for (int i = 0; i < 5; i++) map.insert(i, i * 10);
+  map.erase(1);
+
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.key_at(1), 4);
+  EXPECT_EQ(map.value_at(1), 40);
+  EXPECT_EQ(map.get(4), 40);
+  EXPECT_ANY_THROW(map.key_at(4));
+}
+
+TEST(DenseHashMapTest, ChurnAndClear) {
+  DenseHashMap<int, int> map;
+
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 1000; i++) map.insert(i, round);
+    for (int i = 0; i < 1000; i += 3) map.erase(i);
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    if (i % 3) {
+      EXPECT_EQ(map.get(i), 9);
+    } else {
+      EXPECT_FALSE(map.has(i));
+    }
+  }
+
+  size_t capacity = map.capacity();
+  map.clear();
+  EXPECT_TRUE(map.is_empty());
+  EXPECT_EQ(map.capacity(), capacity);
+  EXPECT_FALSE(map.has(1));
+
+  map.insert(1, 1);
+  EXPECT_EQ(map.get(1), 1);
+}
+
+TEST(DenseHashMapTest, StringKeysAndValues) {
+  DenseHashMap<std::string, std::string> map;
+
+  for (int i = 0; i < 1000; i++)
+    map.insert(std::to_string(i), std::string(40, 'a' + i % 26));
+  for (int i = 0; i < 1000; i += 2) map.erase(std::to_string(i));
+
+  EXPECT_EQ(map.size(), 500);
+  for (int i = 1; i < 1000; i += 2)
+    EXPECT_EQ(map.get(std::to_string(i)), std::string(40, 'a' + i % 26));
+  EXPECT_FALSE(map.has("0"));
+}
@@ -0,0 +1,51 @@
+#include "../FrozenHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../HashMapV1.h"
+
+TEST(FrozenHashMapTest, EmptyInitialization) {
+  FrozenHashMap<char, int> map;
+  EXPECT_TRUE(map.is_empty());
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(FrozenHashMapTest, BuildsFromHashMap) {
+  HashMap<std::string, int> source;
+  for (int i = 0; i < 10000; i++) source.insert(std::to_string(i), i);
+
+  FrozenHashMap<std::string, int> map(source);
+
+  EXPECT_EQ(map.size(), 10000);
+  for (int i = 0; i < 10000; i++) EXPECT_EQ(map.get(std::to_string(i)), i);
+  for (int i = 10000; i < 20000; i++) EXPECT_FALSE(map.has(std::to_string(i)));
+}
+
+TEST(FrozenHashMapTest, BuildsFromRange) {
+  std::vector<std::pair<char, int> > pairs;
+  for (int i = 0; i < 26; i++) pairs.push_back(std::make_pair('a' + i, i));
+  pairs.push_back(std::make_pair('a', 100));
+
+  FrozenHashMap<char, int> map(pairs.begin(), pairs.end());
+
+  // the duplicate 'a' overwrites the first, as a HashMap insert would
+  EXPECT_EQ(map.size(), 26);
+  EXPECT_EQ(map.get('a'), 100);
+  for (int i = 1; i < 26; i++) EXPECT_EQ(map.get('a' + i), i);
+  EXPECT_FALSE(map.has('A'));
+}
+
+TEST(FrozenHashMapTest, SingleKey) {
+  std::pair<int, int> pair(7, 49);
+  FrozenHashMap<int, int> map(&pair, &pair + 1);
+
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.get(7), 49);
+  EXPECT_FALSE(map.has(8));
+}
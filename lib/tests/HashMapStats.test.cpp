@@ -0,0 +1,75 @@
+#include "../HashMapStats.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../HashMapV1.h"
+
+typedef HashMap<int, int, std::hash<int>, std::equal_to<int>,
+                std::allocator<std::pair<const int, int> >, HashMapStats>
+    CountingHashMap;
+
+TEST(HashMapStatsTest, CountsLookupsAndInserts) {
+  CountingHashMap map;
+
+  for (int i = 0; i < 100; i++) map.insert(i, i);
+  for (int i = 0; i < 200; i++) map.has(i);
+  map.get(5);
+
+  const HashMapStats &stats = map.stats();
+  EXPECT_EQ(stats.inserts(), 100);
+  EXPECT_EQ(stats.lookups(), 201);
+  EXPECT_GE(stats.max_lookup_probes(), 1);
+  EXPECT_GT(stats.average_lookup_probes(), 0);
+  EXPECT_LT(stats.average_lookup_probes(), 4);
+
+  // capacity went 0 -> 1 -> 2 -> ... -> 128
+  EXPECT_EQ(stats.rehashes(), 8);
+}
+
+TEST(HashMapStatsTest, TracksBytesAllocated) {
+  CountingHashMap map;
+  EXPECT_EQ(map.stats().bytes_allocated(), 0);
+
+  for (int i = 0; i < 64; i++) map.insert(i, i);
+  uint64_t full = map.stats().bytes_allocated();
+  // 64 nodes of a key, a value and a next pointer, plus 64 buckets
+  EXPECT_GE(full, 64 * (2 * sizeof(int) + 2 * sizeof(void *)));
+  EXPECT_GE(map.stats().peak_bytes_allocated(), full);
+
+  for (int i = 0; i < 64; i++) map.erase(i);
+  EXPECT_EQ(map.stats().bytes_allocated(), 64 * sizeof(void *));
+
+  map.stats().reset();
+  EXPECT_EQ(map.stats().lookups(), 0);
+  EXPECT_EQ(map.stats().peak_bytes_allocated(), 64 * sizeof(void *));
+}
+
+struct ConstantHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(HashMapStatsTest, ExposesBadHashes) {
+  HashMap<int, int, ConstantHash, std::equal_to<int>,
+          std::allocator<std::pair<const int, int> >, HashMapStats>
+      map;
+
+  for (int i = 0; i < 100; i++) map.insert(i, i);
+
+  // every key lands in one chain
+  std::vector<size_t> histogram = map.chain_length_histogram();
+  ASSERT_EQ(histogram.size(), 101);
+  EXPECT_EQ(histogram[100], 1);
+  EXPECT_EQ(histogram[0], map.capacity() - 1);
+  EXPECT_EQ(map.stats().max_insert_probes(), 99);
+}
+
+TEST(HashMapStatsTest, NoStatsTakeNoSpace) {
+  // the empty allocators and NoHashMapStats share the seed's storage
+  EXPECT_EQ(sizeof(HashMap<int, int>),
+            sizeof(CountingHashMap) - sizeof(HashMapStats));
+}
@@ -2,6 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
 TEST(HashMapTest, EmptyInitialization) {
   HashMap<char, int> map;
   EXPECT_EQ(map.size(), 0);
@@ -51,3 +58,436 @@ TEST(HashMapTest, NoDuplicateKeys) {
   EXPECT_EQ(map.size(), 1);
   EXPECT_EQ(map.get(0), 1);
 }
+
+TEST(HashMapTest, SequentialIntegerKeys) {
+  // std::hash<int> is the identity, so this relies on the mixer to spread
+  // neighbouring keys across the masked buckets
+  HashMap<int, int> map;
+  for (int i = 0; i < 100000; i++) map.insert(i << 8, i);
+
+  EXPECT_EQ(map.size(), 100000);
+  EXPECT_EQ(map.capacity(), 131072);
+
+  for (int i = 0; i < 100000; i++) {
+    EXPECT_EQ(map.get(i << 8), i);
+    EXPECT_FALSE(map.has((i << 8) + 1));
+  }
+}
+
+TEST(HashMapTest, IncrementalRehash) {
+  HashMap<int, int> map;
+  map.set_rehash_step(1);
+
+  for (int i = 0; i < 64; i++) map.insert(i, i);
+  EXPECT_EQ(map.capacity(), 64);
+
+  // the 65th insert allocates 128 buckets but moves only one of the old 64
+  map.insert(64, 64);
+  EXPECT_EQ(map.capacity(), 128);
+  EXPECT_TRUE(map.is_rehashing());
+
+  // lookups see every key while nodes are split across both tables
+  for (int i = 0; i <= 64; i++) EXPECT_EQ(map.get(i), i);
+
+  // overwrites and erasures find keys that have not been moved yet
+  map.insert(63, -63);
+  map.erase(62);
+  EXPECT_EQ(map.get(63), -63);
+  EXPECT_FALSE(map.has(62));
+  EXPECT_EQ(map.size(), 64);
+
+  for (int i = 65; i < 128 && map.is_rehashing(); i++) map.insert(i, i);
+  EXPECT_FALSE(map.is_rehashing());
+
+  for (int i = 0; i < 62; i++) EXPECT_EQ(map.get(i), i);
+  EXPECT_FALSE(map.has(62));
+  EXPECT_EQ(map.get(63), -63);
+  EXPECT_EQ(map.get(64), 64);
+}
+
+// counts resizes that begin while the previous one is still moving buckets
+class UnfinishedRehashes : public NoHashMapStats {
+ public:
+  std::function<bool()> _is_rehashing;
+  int _resizes = 0;
+  int _unfinished = 0;
+
+  void on_rehash_begin() {
+    _resizes++;
+    if (_is_rehashing()) _unfinished++;
+  }
+};
+
+TEST(HashMapTest, IncrementalRehashFinishesBeforeNextGrowth) {
+  for (float max_load_factor : {0.25f, 0.3f, 0.7f, 1.0f, 3.0f}) {
+    HashMap<int, int, std::hash<int>, std::equal_to<int>,
+            std::allocator<std::pair<const int, int> >, UnfinishedRehashes>
+        map;
+    map.stats()._is_rehashing = [&]() { return map.is_rehashing(); };
+    map.set_max_load_factor(max_load_factor);
+    map.set_rehash_step(1);
+
+    for (int i = 0; i < 100000; i++) map.insert(i, i);
+
+    EXPECT_GT(map.stats()._resizes, 10) << max_load_factor;
+    EXPECT_EQ(map.stats()._unfinished, 0) << max_load_factor;
+  }
+}
+
+TEST(HashMapTest, IncrementalRehashMatchesEagerRehash) {
+  HashMap<int, int> eager;
+  HashMap<int, int> incremental;
+  incremental.set_rehash_step(2);
+
+  for (int i = 0; i < 10000; i++) {
+    eager.insert(i * 7, i);
+    incremental.insert(i * 7, i);
+    if (i % 3 == 0) {
+      eager.erase(i * 7 / 2);
+      incremental.erase(i * 7 / 2);
+    }
+  }
+
+  EXPECT_EQ(eager.size(), incremental.size());
+  EXPECT_EQ(eager.capacity(), incremental.capacity());
+  for (int i = 0; i < 70000; i++) EXPECT_EQ(eager.has(i), incremental.has(i));
+
+  // leave a rehash in flight; the destructor must free both tables
+  while (incremental.size() < incremental.capacity()) {
+    incremental.insert(-1 - int(incremental.size()), 0);
+  }
+  incremental.insert(1 << 30, 0);
+  EXPECT_TRUE(incremental.is_rehashing());
+}
+
+TEST(HashMapTest, TryEmplaceAndInsertOrAssign) {
+  HashMap<std::string, std::string> map;
+
+  std::string key = "key";
+  std::string value = "value";
+
+  std::pair<std::string *, bool> result =
+      map.try_emplace(std::move(key), std::move(value));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(*result.first, "value");
+
+  // a present key leaves the rvalue arguments untouched
+  std::string again = "key";
+  std::string other = "other";
+  result = map.try_emplace(std::move(again), std::move(other));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(*result.first, "value");
+  EXPECT_EQ(again, "key");
+  EXPECT_EQ(other, "other");
+
+  result = map.insert_or_assign("key", "assigned");
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(map.get("key"), "assigned");
+
+  result = map.try_emplace("padded", 3, '*');
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(map.get("padded"), "***");
+
+  result = map.emplace("padded", "ignored");
+  EXPECT_FALSE(result.second);
+  result = map.emplace("new", "emplaced");
+  EXPECT_TRUE(result.second);
+
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(*map.find("new"), "emplaced");
+  EXPECT_EQ(map.find("missing"), nullptr);
+}
+
+TEST(HashMapTest, MoveOnlyValues) {
+  HashMap<int, std::unique_ptr<int> > map;
+
+  for (int i = 0; i < 100; i++) map.try_emplace(i, new int(i));
+  map.insert_or_assign(0, std::unique_ptr<int>(new int(-1)));
+
+  EXPECT_EQ(map.size(), 100);
+  EXPECT_EQ(*map.get(0), -1);
+  EXPECT_EQ(*map.get(99), 99);
+}
+
+struct TransparentStringHash {
+  typedef void is_transparent;
+  size_t operator()(std::string_view s) const {
+    return std::hash<std::string_view>()(s);
+  }
+};
+
+TEST(HashMapTest, HeterogeneousLookup) {
+  HashMap<std::string, int, TransparentStringHash, std::equal_to<> > map;
+  map.insert("alpha", 1);
+  map.insert("beta", 2);
+
+  std::string_view alpha = "alpha";
+  EXPECT_TRUE(map.has(alpha));
+  EXPECT_EQ(map.get(alpha), 1);
+  EXPECT_EQ(*map.find(std::string_view("beta")), 2);
+  EXPECT_EQ(map.find(std::string_view("gamma")), nullptr);
+
+  map.erase(alpha);
+  EXPECT_FALSE(map.has("alpha"));
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(HashMapTest, FindBatch) {
+  HashMap<int, int> map;
+
+  int keys[100];
+  int *values[100];
+  for (int i = 0; i < 100; i++) keys[i] = i;
+
+  // an empty map finds nothing
+  EXPECT_EQ(map.find_batch(keys, 100, values), 0);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(values[i], nullptr);
+
+  for (int i = 0; i < 100; i += 3) map.insert(i, i * 10);
+
+  EXPECT_EQ(map.find_batch(keys, 100, values), 34);
+  for (int i = 0; i < 100; i++) {
+    if (i % 3) {
+      EXPECT_EQ(values[i], nullptr);
+    } else {
+      ASSERT_NE(values[i], nullptr);
+      EXPECT_EQ(*values[i], i * 10);
+      EXPECT_EQ(values[i], map.find(i));
+    }
+  }
+}
+
+TEST(HashMapTest, ForEachVisitsEveryEntry) {
+  HashMap<int, int> map;
+  map.set_rehash_step(1);
+
+  for (int i = 0; i < 100; i++) map.insert(i, i);
+  ASSERT_TRUE(map.is_rehashing());
+
+  int count = 0, sum = 0;
+  map.for_each([&](const int &key, int &value) {
+    count++;
+    sum += key;
+    value = -value;
+  });
+
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(sum, 4950);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(map.get(i), -i);
+}
+
+TEST(HashMapTest, ReserveAvoidsGrowth) {
+  HashMap<int, int> map;
+  map.reserve(1000);
+
+  EXPECT_EQ(map.capacity(), 1024);
+  for (int i = 0; i < 1000; i++) map.insert(i, i);
+  EXPECT_EQ(map.capacity(), 1024);
+
+  // reserve never shrinks
+  map.reserve(10);
+  EXPECT_EQ(map.capacity(), 1024);
+}
+
+TEST(HashMapTest, MaxLoadFactor) {
+  HashMap<int, int> map;
+  map.set_max_load_factor(0.5);
+
+  for (int i = 0; i < 1000; i++) {
+    map.insert(i, i);
+    ASSERT_LE(map.load_factor(), 0.5);
+  }
+  EXPECT_EQ(map.capacity(), 2048);
+
+  // raising the limit lets the table fill further before growing
+  map.set_max_load_factor(4);
+  for (int i = 1000; i < 8000; i++) map.insert(i, i);
+  EXPECT_EQ(map.capacity(), 2048);
+  for (int i = 0; i < 8000; i++) EXPECT_EQ(map.get(i), i);
+
+  EXPECT_THROW(map.set_max_load_factor(0), std::invalid_argument);
+}
+
+TEST(HashMapTest, RehashAndShrinkToFit) {
+  HashMap<int, int> map;
+  map.set_rehash_step(1);
+
+  for (int i = 0; i < 1000; i++) map.insert(i, i);
+  map.rehash(4096);
+  EXPECT_EQ(map.capacity(), 4096);
+  EXPECT_FALSE(map.is_rehashing());
+
+  for (int i = 0; i < 990; i++) map.erase(i);
+  map.shrink_to_fit();
+  EXPECT_EQ(map.capacity(), 16);
+  for (int i = 990; i < 1000; i++) EXPECT_EQ(map.get(i), i);
+
+  for (int i = 990; i < 1000; i++) map.erase(i);
+  map.shrink_to_fit();
+  EXPECT_EQ(map.capacity(), 0);
+
+  map.insert(1, 1);
+  EXPECT_EQ(map.get(1), 1);
+}
+
+TEST(HashMapTest, MinLoadFactorShrinksAfterErase) {
+  HashMap<int, int> map;
+  map.set_min_load_factor(0.25);
+
+  for (int i = 0; i < 1024; i++) map.insert(i, i);
+  EXPECT_EQ(map.capacity(), 1024);
+
+  for (int i = 0; i < 1000; i++) map.erase(i);
+  EXPECT_LE(map.capacity(), 128);
+  EXPECT_GE(map.load_factor(), 0.25);
+  for (int i = 1000; i < 1024; i++) EXPECT_EQ(map.get(i), i);
+
+  EXPECT_THROW(map.set_min_load_factor(0.75), std::invalid_argument);
+}
+
+struct CountingStringHash {
+  static size_t calls;
+  size_t operator()(const std::string &key) const {
+    calls++;
+    return std::hash<std::string>()(key);
+  }
+};
+
+size_t CountingStringHash::calls = 0;
+
+TEST(HashMapTest, ShrinkLeavesRoomToGrow) {
+  HashMap<int, int, std::hash<int>, std::equal_to<int>,
+          std::allocator<std::pair<const int, int> >, HashMapStats>
+      map;
+  map.set_min_load_factor(0.3);
+
+  for (int i = 0; i < 16; i++) map.insert(i, i);
+  EXPECT_EQ(map.capacity(), 16);
+
+  // dropping to 4 entries shrinks to 8 buckets, not 4, so the next insert
+  // does not grow the table straight back
+  for (int i = 4; i < 16; i++) map.erase(i);
+  EXPECT_EQ(map.capacity(), 8);
+
+  map.stats().reset();
+  for (int i = 0; i < 100; i++) {
+    map.insert(4, 4);
+    map.erase(4);
+  }
+  EXPECT_EQ(map.stats().rehashes(), 0);
+  EXPECT_EQ(map.capacity(), 8);
+}
+
+TEST(HashMapTest, CachedHashesSkipRehashing) {
+  ASSERT_TRUE(HashMapCacheHash<std::string>::value);
+  ASSERT_FALSE(HashMapCacheHash<int>::value);
+
+  HashMap<std::string, int, CountingStringHash> map;
+  CountingStringHash::calls = 0;
+
+  // ten resizes, but each key is hashed only when it is inserted
+  for (int i = 0; i < 1000; i++) map.insert(std::to_string(i), i);
+  EXPECT_EQ(CountingStringHash::calls, 1000);
+
+  for (int i = 0; i < 1000; i++) EXPECT_EQ(map.get(std::to_string(i)), i);
+  EXPECT_EQ(CountingStringHash::calls, 2000);
+}
+
+TEST(HashMapTest, BloomFilterRejectsMisses) {
+  HashMap<int, int, std::hash<int>, std::equal_to<int>,
+          std::allocator<std::pair<const int, int> >, HashMapStats>
+      map;
+  map.set_filter_bits(10);
+  EXPECT_EQ(map.filter_bits(), 10);
+
+  for (int i = 0; i < 10000; i++) map.insert(i * 2, i);
+  for (int i = 0; i < 5000; i++) map.erase(i * 2);
+
+  // the filter never hides a present key, across resizes and erasures
+  for (int i = 5000; i < 10000; i++) EXPECT_EQ(map.get(i * 2), i);
+
+  map.stats().reset();
+  int passed = 0;
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_FALSE(map.has(i * 2 + 1));
+    passed += map.stats().max_lookup_probes() > 0;
+    map.stats().reset();
+  }
+  EXPECT_LT(passed, 500);
+
+  // turning the filter off sends every lookup to the table again
+  map.set_filter_bits(0);
+  for (int i = 5000; i < 10000; i++) EXPECT_TRUE(map.has(i * 2));
+  EXPECT_FALSE(map.has(1));
+}
+
+TEST(HashMapTest, BloomFilterDuringIncrementalRehash) {
+  HashMap<int, int, std::hash<int>, std::equal_to<int>,
+          std::allocator<std::pair<const int, int> >, HashMapStats>
+      map;
+  map.set_rehash_step(1);
+  map.set_filter_bits(10);
+
+  // every present key passes the filter while its chain is in either table
+  for (int i = 0; i < 5000; i++) {
+    map.insert(i * 2, i);
+    if (i % 97 == 0) {
+      for (int j = 0; j <= i; j++) ASSERT_EQ(map.get(j * 2), j);
+    }
+  }
+
+  for (int i = 0; i < 1200; i++) map.insert(10000 + i * 2, i);
+  ASSERT_TRUE(map.is_rehashing());
+
+  // misses are still filtered mid-rehash, in moved and unmoved chains alike
+  map.stats().reset();
+  int passed = 0;
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_FALSE(map.has(i * 2 + 1));
+    passed += map.stats().max_lookup_probes() > 0;
+    map.stats().reset();
+  }
+  EXPECT_LT(passed, 500);
+
+  // changing the filter mid-rehash refills both tables' filters
+  map.set_filter_bits(16);
+  ASSERT_TRUE(map.is_rehashing());
+  for (int i = 0; i < 5000; i++) EXPECT_EQ(map.get(i * 2), i);
+  for (int i = 0; i < 1200; i++) EXPECT_EQ(map.get(10000 + i * 2), i);
+}
+
+TEST(HashMapTest, ParallelBuild) {
+  std::vector<std::pair<int, int> > pairs;
+  for (int i = 0; i < 100000; i++) pairs.emplace_back(i % 60000, i);
+
+  HashMap<int, int> map;
+  map.set_rehash_step(1);
+  map.set_filter_bits(10);
+  map.insert(-1, -1);
+  map.insert(0, -1);
+
+  map.build(pairs.begin(), pairs.end(), 4);
+
+  // the last of each run of equal keys wins, as with repeated inserts
+  EXPECT_EQ(map.size(), 60001);
+  EXPECT_FALSE(map.is_rehashing());
+  EXPECT_EQ(map.get(-1), -1);
+  for (int i = 0; i < 60000; i++)
+    EXPECT_EQ(map.get(i), i < 40000 ? i + 60000 : i);
+  EXPECT_FALSE(map.has(60000));
+}
+
+TEST(HashMapTest, ParallelBuildCachedHashes) {
+  std::vector<std::pair<std::string, int> > pairs;
+  for (int i = 0; i < 10000; i++) pairs.emplace_back(std::to_string(i), i);
+
+  HashMap<std::string, int> map;
+  map.build(pairs.begin(), pairs.end());
+
+  EXPECT_EQ(map.size(), 10000);
+  for (int i = 0; i < 10000; i++) EXPECT_EQ(map.get(std::to_string(i)), i);
+
+  // the new nodes carry their hashes through later resizes
+  map.rehash(65536);
+  for (int i = 0; i < 10000; i++) EXPECT_EQ(map.get(std::to_string(i)), i);
+}
@@ -0,0 +1,89 @@
+#include "../HashMapV2.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(HashMapV2Test, EmptyInitialization) {
+  HashMapV2<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.capacity(), 0);
+  EXPECT_TRUE(map.is_empty());
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(HashMapV2Test, HandlesAlphabet) {
+  HashMapV2<char, int> map;
+
+  for (int i = 0; i < 26; i++) {
+    map.insert('a' + i, i);
+  }
+
+  EXPECT_EQ(map.size(), 26);
+  EXPECT_EQ(map.capacity(), 32);
+
+  for (int i = 0; i < 26; i++) {
+    EXPECT_TRUE(map.has('a' + i));
+    EXPECT_EQ(map.get('a' + i), i);
+  }
+
+  for (int i = 0; i < 26; i++) {
+    map.erase('a' + i);
+  }
+
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.capacity(), 32);
+
+  for (int i = 0; i < 26; i++) {
+    EXPECT_FALSE(map.has('a' + i));
+    EXPECT_ANY_THROW(map.get('a' + i));
+  }
+}
+
+TEST(HashMapV2Test, NoDuplicateKeys) {
+  HashMapV2<int, int> map;
+  map.insert(0, 0);
+  map.insert(0, 1);
+
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.get(0), 1);
+}
+
+TEST(HashMapV2Test, NonTrivialTypes) {
+  HashMapV2<std::string, std::string> map;
+
+  for (int i = 0; i < 1000; i++) {
+    map.insert(std::to_string(i), std::string(64, 'a' + i % 26));
+  }
+
+  EXPECT_EQ(map.size(), 1000);
+  EXPECT_LE(map.load_factor(), 0.875);
+
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(map.get(std::to_string(i)), std::string(64, 'a' + i % 26));
+  }
+}
+
+struct ConstantHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(HashMapV2Test, ChurnWithCollisions) {
+  // every key lands in the same group, so erasures leave deleted markers that
+  // lookups must probe past
+  HashMapV2<int, int, ConstantHash> map;
+
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 40; i++) map.insert(round * 40 + i, i);
+    for (int i = 0; i < 40; i += 2) map.erase(round * 40 + i);
+  }
+
+  EXPECT_EQ(map.size(), 50 * 20);
+
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 40; i++) {
+      EXPECT_EQ(map.has(round * 40 + i), i % 2 == 1);
+    }
+  }
+}
@@ -0,0 +1,34 @@
+#include "../HugePageAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "../Vector.h"
+
+TEST(HugePageAllocatorTest, AlignsSmallAndHugeAllocations) {
+  HugePageAllocator<float> alloc;
+
+  float *small = alloc.allocate(3);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % 64, 0);
+  EXPECT_FALSE(alloc.is_huge(3));
+  alloc.deallocate(small, 3);
+
+  size_t n = (size_t(3) << 20) / sizeof(float);
+  float *huge = alloc.allocate(n);
+  EXPECT_TRUE(alloc.is_huge(n));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(huge) % (size_t(2) << 20), 0);
+  huge[0] = 1;
+  huge[n - 1] = 2;
+  alloc.deallocate(huge, n);
+}
+
+TEST(HugePageAllocatorTest, BacksVectors) {
+  Vector<double, HugePageAllocator<double> > v;
+  for (int i = 0; i < 1 << 20; i++) v.push_back(i);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(v.data()) % (size_t(2) << 20), 0);
+  EXPECT_EQ(v.at(12345), 12345);
+  v.shrink_to_fit();
+  EXPECT_EQ(v.back(), (1 << 20) - 1);
+}
@@ -221,3 +221,32 @@ TEST(LinkedListTest, Swap) {
   EXPECT_EQ(listA.front(), 3);
   EXPECT_EQ(listB.front(), 0);
 }
+
+TEST(LinkedListTest, NodeHandles) {
+  LinkedList<int> list;
+  EXPECT_EQ(list.front_node(), nullptr);
+
+  ListNode<int> *one = list.push_front_node(1);
+  ListNode<int> *two = list.push_front_node(2);
+  ListNode<int> *three = list.push_front_node(3);
+
+  EXPECT_EQ(list.front_node(), three);
+  EXPECT_EQ(list.back_node(), one);
+  EXPECT_EQ(three->next(), two);
+  EXPECT_EQ(two->prev(), three);
+
+  list.move_to_front(one);
+  EXPECT_EQ(list.front(), 1);
+  EXPECT_EQ(list.back(), 2);
+  EXPECT_EQ(one->value(), 1);
+
+  list.erase_node(three);
+  EXPECT_EQ(list.size(), 2);
+  EXPECT_EQ(list.at(0), 1);
+  EXPECT_EQ(list.at(1), 2);
+
+  list.erase_node(two);
+  list.erase_node(one);
+  EXPECT_TRUE(list.is_empty());
+  EXPECT_EQ(list.back_node(), nullptr);
+}
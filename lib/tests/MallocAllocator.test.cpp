@@ -0,0 +1,48 @@
+#include "../MallocAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "../Vector.h"
+
+TEST(MallocAllocatorTest, ReallocatesAcrossTheMapThreshold) {
+  MallocAllocator<uint64_t> alloc;
+  size_t small = 1000;
+  size_t large = (size_t(1) << 20) / sizeof(uint64_t);
+  EXPECT_FALSE(alloc.is_mapped(small));
+  EXPECT_TRUE(alloc.is_mapped(large));
+
+  uint64_t *p = alloc.allocate(small);
+  for (size_t i = 0; i < small; i++) p[i] = i;
+
+  // heap to mapping, mapping to a larger mapping, then back to the heap
+  p = alloc.reallocate(p, small, large);
+  for (size_t i = small; i < large; i++) p[i] = i;
+  p = alloc.reallocate(p, large, 4 * large);
+  for (size_t i = 0; i < large; i++) ASSERT_EQ(p[i], i);
+  p[4 * large - 1] = 7;
+
+  p = alloc.reallocate(p, 4 * large, small / 2);
+  for (size_t i = 0; i < small / 2; i++) ASSERT_EQ(p[i], i);
+  alloc.deallocate(p, small / 2);
+}
+
+TEST(MallocAllocatorTest, GrowsLargeVectorsInPlace) {
+  Vector<uint32_t> v;
+  size_t n = size_t(1) << 20;
+  for (size_t i = 0; i < n; i++) v.push(static_cast<uint32_t>(i));
+
+  EXPECT_TRUE(MallocAllocator<uint32_t>::is_mapped(v.capacity()));
+  for (size_t i = 0; i < n; i += 4093) ASSERT_EQ(v[i], i);
+
+  v.resize(10);
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 10);
+  EXPECT_EQ(v.back(), 9);
+}
+
+TEST(MallocAllocatorTest, TakesNoSpaceInVectors) {
+  // a Vector is its data pointer, size and capacity, and nothing for Alloc
+  EXPECT_EQ(sizeof(Vector<int>), sizeof(int *) + 2 * sizeof(size_t));
+}
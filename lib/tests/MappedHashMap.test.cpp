@@ -0,0 +1,119 @@
+#include "../MappedHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "../HashMapV1.h"
+
+TEST(MappedHashMapTest, SaveAndOpen) {
+  std::string path = testing::TempDir() + "MappedHashMapTest.SaveAndOpen";
+
+  {
+    HashMap<uint64_t, double> map;
+    for (uint64_t i = 0; i < 5000; i++) map.insert(i * 7, i / 2.0);
+    MappedHashMap<uint64_t, double>::save(map, path);
+  }
+
+  MappedHashMap<uint64_t, double> mapped(path);
+
+  EXPECT_EQ(mapped.size(), 5000);
+  for (uint64_t i = 0; i < 5000; i++) EXPECT_EQ(mapped.get(i * 7), i / 2.0);
+  for (uint64_t i = 0; i < 5000; i++) EXPECT_FALSE(mapped.has(i * 7 + 1));
+  EXPECT_THROW(mapped.get(1), std::out_of_range);
+
+  std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, EmptyMap) {
+  std::string path = testing::TempDir() + "MappedHashMapTest.EmptyMap";
+
+  HashMap<int, int> map;
+  MappedHashMap<int, int>::save(map, path);
+  MappedHashMap<int, int> mapped(path);
+
+  EXPECT_TRUE(mapped.is_empty());
+  EXPECT_FALSE(mapped.has(0));
+
+  std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, RejectsOtherFiles) {
+  std::string path = testing::TempDir() + "MappedHashMapTest.RejectsOtherFiles";
+
+  EXPECT_THROW((MappedHashMap<int, int>(path + ".missing")), std::system_error);
+
+  HashMap<int, int> map;
+  map.insert(1, 2);
+  MappedHashMap<int, int>::save(map, path);
+
+  // a snapshot of int keys cannot be read as long keys
+  EXPECT_THROW((MappedHashMap<long, int>(path)), std::runtime_error);
+
+  std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, SaveReplacesOpenSnapshot) {
+  std::string path =
+      testing::TempDir() + "MappedHashMapTest.SaveReplacesOpenSnapshot";
+
+  HashMap<int, int> map;
+  for (int i = 0; i < 1000; i++) map.insert(i, i);
+  MappedHashMap<int, int>::save(map, path);
+  MappedHashMap<int, int> old_mapped(path);
+
+  for (int i = 0; i < 1000; i++) map.insert(i, -i);
+  MappedHashMap<int, int>::save(map, path);
+  MappedHashMap<int, int> new_mapped(path);
+
+  // the old mapping still reads the snapshot it opened
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(old_mapped.get(i), i);
+    EXPECT_EQ(new_mapped.get(i), -i);
+  }
+  EXPECT_THROW((MappedHashMap<int, int>(path + ".tmp")), std::system_error);
+
+  std::remove(path.c_str());
+}
+
+TEST(MappedHashMapTest, RejectsCorruptSnapshots) {
+  std::string path =
+      testing::TempDir() + "MappedHashMapTest.RejectsCorruptSnapshots";
+
+  HashMap<int, int> map;
+  for (int i = 0; i < 100; i++) map.insert(i, i);
+  MappedHashMap<int, int>::save(map, path);
+
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  std::string image(4096, '\0');
+  image.resize(std::fread(&image[0], 1, image.size(), file));
+  std::fclose(file);
+
+  // bucket_count and size follow the magic and three 8-byte fields
+  auto rejects = [&](size_t at, uint64_t value) {
+    std::string corrupt = image;
+    memcpy(&corrupt[at], &value, sizeof(value));
+    std::FILE *out = std::fopen(path.c_str(), "wb");
+    std::fwrite(corrupt.data(), 1, corrupt.size(), out);
+    std::fclose(out);
+    EXPECT_THROW((MappedHashMap<int, int>(path)), std::runtime_error);
+  };
+
+  rejects(32, 0);
+  rejects(32, 3);
+  rejects(32, uint64_t(1) << 62);
+  rejects(40, uint64_t(1) << 62);
+  rejects(40, 99);
+
+  // offsets: the first must be 0 and they may never decrease
+  rejects(48, 1);
+  rejects(48 + 8 * 64, 0);
+  rejects(48 + 8 * 128, 1000);
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,109 @@
+#include "../RobinHoodHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+TEST(RobinHoodHashMapTest, EmptyInitialization) {
+  RobinHoodHashMap<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.capacity(), 0);
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(RobinHoodHashMapTest, HandlesAlphabet) {
+  RobinHoodHashMap<char, int> map;
+
+  for (int i = 0; i < 26; i++) map.insert('a' + i, i);
+
+  EXPECT_EQ(map.size(), 26);
+  EXPECT_EQ(map.capacity(), 32);
+
+  for (int i = 0; i < 26; i++) EXPECT_EQ(map.get('a' + i), i);
+
+  for (int i = 0; i < 26; i++) map.erase('a' + i);
+
+  EXPECT_TRUE(map.is_empty());
+  for (int i = 0; i < 26; i++) EXPECT_FALSE(map.has('a' + i));
+}
+
+TEST(RobinHoodHashMapTest, RunsAtHighLoadFactor) {
+  RobinHoodHashMap<int, int> map;
+
+  for (int i = 0; i < 921; i++) map.insert(i, i);
+
+  // 921 / 1024 is just under 0.9, so the table has not grown past 1024
+  EXPECT_EQ(map.capacity(), 1024);
+  EXPECT_GT(map.load_factor(), 0.89);
+  EXPECT_LE(map.load_factor(), map.max_load_factor());
+
+  for (int i = 0; i < 921; i++) EXPECT_EQ(map.get(i), i);
+  for (int i = 921; i < 2000; i++) EXPECT_FALSE(map.has(i));
+}
+
+TEST(RobinHoodHashMapTest, BackwardShiftDeletion) {
+  RobinHoodHashMap<std::string, int> map;
+
+  for (int round = 0; round < 20; round++) {
+    for (int i = 0; i < 500; i++) map.insert(std::to_string(i), round);
+    for (int i = 0; i < 500; i += 2) map.erase(std::to_string(i));
+  }
+
+  EXPECT_EQ(map.size(), 250);
+  for (int i = 0; i < 500; i++) {
+    EXPECT_EQ(map.has(std::to_string(i)), i % 2 == 1);
+  }
+  EXPECT_EQ(map.get("499"), 19);
+}
+
+struct CoarseHash {
+  size_t operator()(int key) const { return key / 64; }
+};
+
+TEST(RobinHoodHashMapTest, ClusteredHashes) {
+  // runs of 64 keys share a hash value, so inserts displace long chains
+  RobinHoodHashMap<int, int, CoarseHash> map;
+
+  for (int i = 0; i < 4096; i++) map.insert(i, i);
+  for (int i = 0; i < 4096; i += 3) map.erase(i);
+
+  for (int i = 0; i < 4096; i++) {
+    EXPECT_EQ(map.has(i), i % 3 != 0);
+  }
+}
+
+struct ConstantHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(RobinHoodHashMapTest, TooManyCollisionsThrows) {
+  // one-byte distances keep entries within 254 slots of home
+  RobinHoodHashMap<int, int, ConstantHash, std::equal_to<int>, uint8_t> map;
+
+  for (int i = 0; i < 254; i++) map.insert(i, i);
+  size_t capacity = map.capacity();
+  EXPECT_THROW(map.insert(254, 254), std::overflow_error);
+
+  // the doubling that could not help is undone, and nothing else is lost
+  EXPECT_EQ(map.capacity(), capacity);
+  EXPECT_EQ(map.size(), 254);
+  EXPECT_FALSE(map.has(254));
+  for (int i = 0; i < 254; i++) EXPECT_EQ(map.get(i), i);
+}
+
+struct GroupHash {
+  size_t operator()(int key) const { return key / 254; }
+};
+
+TEST(RobinHoodHashMapTest, CollidingGroupsDoNotInflateTable) {
+  RobinHoodHashMap<int, int, GroupHash> map;
+
+  for (int i = 0; i < 50 * 254; i++) map.insert(i, i);
+
+  EXPECT_EQ(map.size(), 50 * 254);
+  EXPECT_LE(map.capacity(), 4 * map.size());
+  for (int i = 0; i < 50 * 254; i++) EXPECT_EQ(map.get(i), i);
+}
@@ -0,0 +1,89 @@
+#include "../SlabAllocator.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "../HashMapV1.h"
+
+TEST(SlabAllocatorTest, ReusesFreedStorage) {
+  SlabAllocator<long> alloc;
+
+  long *a = alloc.allocate(1);
+  long *b = alloc.allocate(1);
+  EXPECT_NE(a, b);
+
+  alloc.deallocate(a, 1);
+  EXPECT_EQ(alloc.allocate(1), a);
+
+  alloc.deallocate(a, 1);
+  alloc.deallocate(b, 1);
+}
+
+TEST(SlabAllocatorTest, CopiesAndRebindsSharePool) {
+  SlabAllocator<int> a;
+  SlabAllocator<int> b(a);
+  SlabAllocator<double> c(a);
+  SlabAllocator<int> d;
+
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a == c);
+  EXPECT_TRUE(a != d);
+
+  d = a;
+  EXPECT_TRUE(a == d);
+
+  // storage from one copy can be released through another
+  int *p = a.allocate(1);
+  b.deallocate(p, 1);
+  EXPECT_EQ(d.allocate(1), p);
+  d.deallocate(p, 1);
+}
+
+TEST(SlabAllocatorTest, ArraysFallBackToOperatorNew) {
+  SlabAllocator<int> alloc;
+  int *p = alloc.allocate(1000);
+  for (int i = 0; i < 1000; i++) p[i] = i;
+  alloc.deallocate(p, 1000);
+}
+
+TEST(SlabAllocatorTest, WorksWithStandardContainers) {
+  std::list<int, SlabAllocator<int> > list;
+  for (int i = 0; i < 10000; i++) list.push_back(i);
+  for (int i = 0; i < 5000; i++) list.pop_front();
+  EXPECT_EQ(list.size(), 5000);
+  EXPECT_EQ(list.front(), 5000);
+}
+
+TEST(SlabAllocatorTest, BacksHashMapNodes) {
+  HashMap<int, int, std::hash<int>, std::equal_to<int>,
+          SlabAllocator<std::pair<const int, int> > >
+      map;
+
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 1000; i++) map.insert(i, round);
+    for (int i = 0; i < 1000; i += 2) map.erase(i);
+  }
+
+  EXPECT_EQ(map.size(), 500);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(map.has(i), i % 2 == 1);
+  }
+  EXPECT_EQ(map.get(1), 9);
+}
+
+TEST(SlabAllocatorTest, BacksParallelBuild) {
+  std::vector<std::pair<int, int> > pairs;
+  for (int i = 0; i < 10000; i++) pairs.emplace_back(i, -i);
+
+  // the pool is not thread-safe, so build links every node from one thread
+  HashMap<int, int, std::hash<int>, std::equal_to<int>,
+          SlabAllocator<std::pair<const int, int> > >
+      map;
+  map.build(pairs.begin(), pairs.end(), 4);
+
+  EXPECT_EQ(map.size(), 10000);
+  for (int i = 0; i < 10000; i++) EXPECT_EQ(map.get(i), -i);
+}
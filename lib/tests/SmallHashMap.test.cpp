@@ -0,0 +1,80 @@
+#include "../SmallHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+TEST(SmallHashMapTest, EmptyInitialization) {
+  SmallHashMap<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_TRUE(map.is_small());
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+}
+
+TEST(SmallHashMapTest, StaysInlineUpToN) {
+  SmallHashMap<std::string, int, 4> map;
+
+  for (int i = 0; i < 4; i++) map.insert(std::to_string(i), i);
+  map.insert("0", -1);
+  EXPECT_TRUE(map.is_small());
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.get("0"), -1);
+
+  // swap-removal keeps the remaining entries reachable
+  map.erase("1");
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_FALSE(map.has("1"));
+  EXPECT_EQ(map.get("3"), 3);
+
+  int sum = 0;
+  map.for_each([&](const std::string &, int &value) { sum += value; });
+  EXPECT_EQ(sum, 4);
+}
+
+TEST(SmallHashMapTest, UpgradesWhenFull) {
+  SmallHashMap<std::string, std::shared_ptr<int>, 4> map;
+
+  for (int i = 0; i < 100; i++)
+    map.insert(std::to_string(i), std::make_shared<int>(i));
+
+  EXPECT_FALSE(map.is_small());
+  EXPECT_EQ(map.size(), 100);
+  for (int i = 0; i < 100; i++) EXPECT_EQ(*map.get(std::to_string(i)), i);
+
+  for (int i = 0; i < 100; i += 2) map.erase(std::to_string(i));
+  EXPECT_EQ(map.size(), 50);
+  EXPECT_EQ(map.find("2"), nullptr);
+  EXPECT_EQ(**map.find("3"), 3);
+}
+
+class FlakyCopy {
+ public:
+  static int copies_left;
+  std::string _text;
+
+  explicit FlakyCopy(const std::string &text) : _text(text) {}
+  FlakyCopy(const FlakyCopy &other) : _text(other._text) {
+    if (copies_left-- == 0) throw std::runtime_error("copy");
+  }
+  FlakyCopy(FlakyCopy &&other) noexcept : _text(std::move(other._text)) {}
+  FlakyCopy &operator=(const FlakyCopy &) = default;
+};
+
+int FlakyCopy::copies_left = -1;
+
+TEST(SmallHashMapTest, FailedUpgradeLeavesMapIntact) {
+  SmallHashMap<int, FlakyCopy, 4> map;
+  for (int i = 0; i < 4; i++) map.insert(i, FlakyCopy(std::to_string(i)));
+
+  // the third entry fails to reach the HashMap, after two have
+  FlakyCopy::copies_left = 2;
+  EXPECT_THROW(map.insert(4, FlakyCopy("4")), std::runtime_error);
+  FlakyCopy::copies_left = -1;
+
+  EXPECT_TRUE(map.is_small());
+  EXPECT_EQ(map.size(), 4);
+  for (int i = 0; i < 4; i++) EXPECT_EQ(map.get(i)._text, std::to_string(i));
+}
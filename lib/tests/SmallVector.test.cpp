@@ -0,0 +1,138 @@
+#include "../SmallVector.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+TEST(SmallVectorTest, StartsInlineWithCapacityN) {
+  SmallVector<int, 4> v;
+  EXPECT_EQ(v.size(), 0);
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_TRUE(v.is_small());
+
+  // the elements live inside the object itself
+  for (int i = 0; i < 4; i++) v.push(i);
+  char *object = reinterpret_cast<char *>(&v);
+  char *elements = reinterpret_cast<char *>(v.data());
+  EXPECT_TRUE(elements > object && elements < object + sizeof(v));
+  EXPECT_EQ(v.capacity(), 4);
+
+  v.insert(0, -1);
+  EXPECT_FALSE(v.is_small());
+  EXPECT_EQ(v.capacity(), 8);
+  EXPECT_EQ(v.front(), -1);
+  EXPECT_EQ(v.back(), 3);
+
+  v.remove(0);
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_small());
+  EXPECT_EQ(v.capacity(), 4);
+  for (int i = 0; i < 4; i++) EXPECT_EQ(v.at(i), i);
+  EXPECT_ANY_THROW(v.at(4));
+}
+
+TEST(SmallVectorTest, SizedAndFillConstructors) {
+  SmallVector<int, 4> small(3, 7);
+  EXPECT_TRUE(small.is_small());
+  EXPECT_EQ(small.size(), 3);
+  EXPECT_EQ(small[2], 7);
+
+  SmallVector<int, 4> large(10);
+  EXPECT_FALSE(large.is_small());
+  EXPECT_EQ(large.capacity(), 10);
+  EXPECT_EQ(large[9], 0);
+
+  large.clear();
+  EXPECT_TRUE(large.is_small());
+  EXPECT_EQ(large.capacity(), 4);
+}
+
+TEST(SmallVectorTest, NonTrivialElements) {
+  SmallVector<std::string, 2> v;
+  v.push_back("a");
+  v.emplace_back(3, 'b');
+  EXPECT_TRUE(v.is_small());
+
+  v.push_back(std::string(40, 'c'));
+  EXPECT_FALSE(v.is_small());
+  EXPECT_EQ(v.at(1), "bbb");
+  EXPECT_EQ(v.pop(), std::string(40, 'c'));
+
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_small());
+  EXPECT_EQ(v.at(0), "a");
+  EXPECT_EQ(v.at(1), "bbb");
+
+  // growing again after moving back inline spills as before
+  v.push_back("d");
+  v.reverse();
+  EXPECT_EQ(v.at(0), "d");
+  EXPECT_EQ(v.at(2), "a");
+}
+
+TEST(SmallVectorTest, MoveAndSwap) {
+  SmallVector<std::unique_ptr<int>, 2> small;
+  small.push_back(std::make_unique<int>(1));
+
+  SmallVector<std::unique_ptr<int>, 2> large;
+  for (int i = 0; i < 5; i++) large.push_back(std::make_unique<int>(i));
+
+  SmallVector<std::unique_ptr<int>, 2> moved(std::move(large));
+  EXPECT_EQ(large.size(), 0);
+  EXPECT_TRUE(large.is_small());
+  EXPECT_EQ(*moved.at(4), 4);
+
+  moved.swap(small);
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_TRUE(moved.is_small());
+  EXPECT_EQ(*moved.at(0), 1);
+  EXPECT_EQ(small.size(), 5);
+  EXPECT_EQ(*small.at(4), 4);
+
+  small = std::move(moved);
+  EXPECT_EQ(small.size(), 1);
+  EXPECT_EQ(*small.at(0), 1);
+  EXPECT_TRUE(moved.is_empty());
+}
+
+TEST(SmallVectorTest, HeapMovesTakeTheBuffer) {
+  static_assert(std::is_nothrow_move_constructible<SmallVector<int, 4> >::value,
+                "moves are noexcept when T's are");
+  static_assert(
+      std::is_nothrow_move_assignable<SmallVector<std::string, 4> >::value,
+      "moves are noexcept when T's are");
+
+  SmallVector<std::string, 2> a;
+  for (int i = 0; i < 100; i++) a.push_back(std::to_string(i));
+  std::string *heap = a.data();
+
+  // a spilled SmallVector hands over its heap buffer, like Vector
+  SmallVector<std::string, 2> b(std::move(a));
+  EXPECT_EQ(b.data(), heap);
+  EXPECT_TRUE(a.is_small());
+  EXPECT_EQ(a.capacity(), 2);
+
+  SmallVector<std::string, 2> c;
+  c.push_back("x");
+  c = std::move(b);
+  EXPECT_EQ(c.data(), heap);
+  EXPECT_EQ(c.at(99), "99");
+  EXPECT_TRUE(b.is_empty());
+
+  SmallVector<std::string, 2> d(5, "y");
+  std::string *other_heap = d.data();
+  c.swap(d);
+  EXPECT_EQ(c.data(), other_heap);
+  EXPECT_EQ(d.data(), heap);
+  EXPECT_EQ(d.size(), 100);
+  EXPECT_EQ(c.at(4), "y");
+
+  // the inline buffers stay with their own objects
+  a.push_back("z");
+  EXPECT_TRUE(a.is_small());
+  b.push_back("w");
+  EXPECT_TRUE(b.is_small());
+  EXPECT_EQ(a.at(0), "z");
+}
@@ -0,0 +1,80 @@
+#include "../TTLHashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(TTLHashMapTest, EmptyInitialization) {
+  TTLHashMap<char, int> map;
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.now(), 0);
+  EXPECT_FALSE(map.has('a'));
+  EXPECT_ANY_THROW(map.get('a'));
+  EXPECT_EQ(map.expire(), 0);
+}
+
+TEST(TTLHashMapTest, ReadsExpireLazily) {
+  TTLHashMap<std::string, int> map;
+  map.insert("a", 1, 10);
+  map.insert("b", 2, 20);
+  map.insert("c", 3, 0);  // already expired
+  EXPECT_EQ(map.size(), 2);
+
+  map.advance(9);
+  EXPECT_EQ(map.get("a"), 1);
+
+  // past the deadline a read erases the entry without waiting for expire
+  map.advance(1);
+  EXPECT_FALSE(map.has("a"));
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.get("b"), 2);
+
+  // overwriting replaces the deadline
+  map.insert("b", 3, 100);
+  map.advance(50);
+  EXPECT_EQ(map.get("b"), 3);
+  map.erase("b");
+  EXPECT_TRUE(map.is_empty());
+}
+
+TEST(TTLHashMapTest, WheelExpiresOnTime) {
+  TTLHashMap<int, int> map;
+
+  // ttls that land on every level of the wheel, and past the top
+  const uint64_t ttls[] = {1, 63, 64, 65, 4095, 4096, 300000, 1 << 24,
+                           (1 << 24) + 1000, uint64_t(1) << 26};
+  for (int i = 0; i < 10; i++) map.insert(i, i, ttls[i]);
+
+  for (int i = 0; i < 10; i++) {
+    map.advance(ttls[i] - 1 - map.now());
+    EXPECT_EQ(map.expire(), 0);
+    EXPECT_EQ(map.size(), size_t(10 - i));
+
+    map.advance(1);
+    EXPECT_EQ(map.expire(), 1);
+    EXPECT_FALSE(map.has(i));
+  }
+  EXPECT_TRUE(map.is_empty());
+}
+
+TEST(TTLHashMapTest, ChurnMatchesDeadlines) {
+  TTLHashMap<int, int> map;
+
+  // entry i lives for 1 + i * 37 % 5000 ticks; every third is rewritten
+  for (int i = 0; i < 1000; i++) {
+    map.insert(i, i, 1 + i * 37 % 5000);
+    map.advance(1);
+    map.expire();
+  }
+  for (int i = 0; i < 1000; i += 3) map.insert(i, -i, 10000);
+
+  for (int t = 0; t < 20000; t += 7) {
+    map.advance(7);
+    map.expire();
+    for (int i = 1; i < 1000; i += 3) {
+      uint64_t deadline = i + 1 + i * 37 % 5000;
+      EXPECT_EQ(map.has(i), deadline > map.now());
+    }
+  }
+  EXPECT_TRUE(map.is_empty());
+}
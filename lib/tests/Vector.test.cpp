@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+
 TEST(VectorTest, BasicConstructor) {
   Vector<int> v;
 
@@ -230,6 +233,42 @@ TEST(VectorTest, IndexOf) {
   EXPECT_EQ(v.index_of([](int n) -> bool { return n == -5; }), -1);
 }
 
+TEST(VectorTest, IndexOfCallable) {
+  Vector<int> v;
+  for (int i = 0; i < 10; i++) v.push(i * i);
+
+  int target = 49;
+  EXPECT_EQ(v.index_of([&](int n) { return n == target; }), 7);
+  EXPECT_EQ(v.index_of([&](int n) { return n > target * 2; }), -1);
+}
+
+TEST(VectorTest, SearchAndReduce) {
+  Vector<int> v(1000, 4);
+  v.assign(700, 9);
+  v.assign(900, 9);
+  v.assign(300, -2);
+
+  EXPECT_EQ(v.find(9), 700);
+  EXPECT_EQ(v.find(5), -1);
+  EXPECT_EQ(v.count(4), 997);
+  EXPECT_EQ(v.min(), -2);
+  EXPECT_EQ(v.max(), 9);
+  EXPECT_EQ(v.sum(), 997 * 4 + 18 - 2);
+
+  Vector<double> empty;
+  EXPECT_ANY_THROW(empty.min());
+  EXPECT_ANY_THROW(empty.max());
+  EXPECT_EQ(empty.sum(), 0);
+  EXPECT_EQ(empty.find(1), -1);
+  empty.reverse();
+
+  Vector<std::string> words;
+  words.push_back("b");
+  words.push_back("a");
+  EXPECT_EQ(words.find("a"), 1);
+  EXPECT_EQ(words.min(), "a");
+}
+
 TEST(VectorTest, Reverse) {
   Vector<int> v(100);
   int *p;
@@ -267,3 +306,56 @@ TEST(VectorTest, Swap) {
     EXPECT_EQ(*(p + i), 100);
   }
 }
+
+TEST(VectorTest, NonTrivialElements) {
+  Vector<std::string> v;
+  for (int i = 0; i < 100; i++) v.push_back(std::string(32, 'a' + i % 26));
+
+  v.insert(0, "front");
+  v.emplace(1, 3, '*');
+  EXPECT_EQ(v.size(), 102);
+  EXPECT_EQ(v.front(), "front");
+  EXPECT_EQ(v.at(1), "***");
+  EXPECT_EQ(v.back(), std::string(32, 'a' + 99 % 26));
+
+  // references stay valid until the next reallocation
+  std::string &s = v.at(2);
+  s += "!";
+  EXPECT_EQ(v[2], std::string(32, 'a') + "!");
+
+  EXPECT_EQ(v.remove(0), "front");
+  EXPECT_EQ(v.pop(), std::string(32, 'a' + 99 % 26));
+  EXPECT_EQ(v.size(), 100);
+
+  // pushing an element of the vector itself survives the reallocation
+  v.shrink_to_fit();
+  v.push_back(v.at(0));
+  EXPECT_EQ(v.back(), "***");
+
+  v.resize(200, "fill");
+  EXPECT_EQ(v.at(199), "fill");
+  v.resize(10);
+  EXPECT_EQ(v.size(), 10);
+  v.reverse();
+  EXPECT_EQ(v.back(), "***");
+}
+
+TEST(VectorTest, MoveOnlyElements) {
+  Vector<std::unique_ptr<int> > v;
+  for (int i = 0; i < 10; i++) v.emplace_back(new int(i));
+  v.push_back(std::unique_ptr<int>(new int(10)));
+
+  std::unique_ptr<int> removed = v.remove(3);
+  EXPECT_EQ(*removed, 3);
+  EXPECT_EQ(*v.at(3), 4);
+  v.pop_back();
+  EXPECT_EQ(*v.back(), 9);
+
+  Vector<std::unique_ptr<int> > moved(std::move(v));
+  EXPECT_EQ(moved.size(), 9);
+  EXPECT_TRUE(v.is_empty());
+
+  v = std::move(moved);
+  EXPECT_EQ(*v.at(0), 0);
+  EXPECT_TRUE(moved.is_empty());
+}
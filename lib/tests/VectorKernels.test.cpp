@@ -0,0 +1,99 @@
+#include "../VectorKernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+template <typename T>
+class VectorKernelsTest : public ::testing::Test {};
+
+typedef ::testing::Types<int8_t, uint8_t, int16_t, int32_t, uint32_t,
+                         int64_t, float, double>
+    KernelTypes;
+TYPED_TEST_SUITE(VectorKernelsTest, KernelTypes);
+
+// Runs the same checks against one set of kernels, at every length up to 100
+// and at an unaligned start, so every register width sees its scalar tail
+template <typename T, typename Kernels>
+void check_kernels() {
+  std::vector<T> values(101);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<T>((i * 37 + 11) % 50);
+  }
+
+  for (size_t n = 0; n <= 100; n++) {
+    const T *p = values.data() + 1;
+
+    size_t count = 0;
+    size_t first = n;
+    T sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (p[i] == T(7)) {
+        count++;
+        if (first == n) first = i;
+      }
+      sum += p[i];
+    }
+
+    ASSERT_EQ(Kernels::find(p, n, T(7)), first) << n;
+    ASSERT_EQ(Kernels::find(p, n, T(99)), n) << n;
+    ASSERT_EQ(Kernels::count(p, n, T(7)), count) << n;
+    if (sizeof(T) > 1) {
+      ASSERT_EQ(Kernels::sum(p, n), sum) << n;
+    }
+
+    if (n) {
+      T lowest = p[0], highest = p[0];
+      for (size_t i = 0; i < n; i++) {
+        if (p[i] < lowest) lowest = p[i];
+        if (p[i] > highest) highest = p[i];
+      }
+      ASSERT_EQ(Kernels::min(p, n), lowest) << n;
+      ASSERT_EQ(Kernels::max(p, n), highest) << n;
+    }
+
+    std::vector<T> reversed(values);
+    Kernels::reverse(reversed.data() + 1, n);
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(reversed[1 + i], p[n - 1 - i]);
+    ASSERT_EQ(reversed[0], values[0]);
+
+    std::vector<T> filled(values);
+    Kernels::fill(filled.data() + 1, n, T(3));
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(filled[1 + i], T(3));
+    if (n < 100) {
+      ASSERT_EQ(filled[n + 1], values[n + 1]);
+    }
+  }
+}
+
+TYPED_TEST(VectorKernelsTest, MatchScalarLoops) {
+  check_kernels<TypeParam, SimdKernels<TypeParam, 16> >();
+  check_kernels<TypeParam, SimdKernels<TypeParam, 32> >();
+  check_kernels<TypeParam, VectorKernels<TypeParam> >();
+}
+
+TEST(VectorKernelsTest, CountsPastNarrowLaneLimits) {
+  // 8-bit tallies would overflow after 127 registers without flushing
+  std::vector<int8_t> values(100000, 1);
+  values[50000] = 2;
+  EXPECT_EQ(VectorKernels<int8_t>::count(values.data(), values.size(), 1),
+            values.size() - 1);
+  EXPECT_EQ(VectorKernels<int8_t>::find(values.data(), values.size(), 2),
+            50000);
+}
+
+TEST(VectorKernelsTest, FallsBackForOtherTypes) {
+  EXPECT_FALSE(HasSimdKernels<std::string>::value);
+  EXPECT_FALSE(HasSimdKernels<bool>::value);
+
+  std::string words[] = {"b", "c", "a", "c"};
+  EXPECT_EQ(VectorKernels<std::string>::find(words, 4, "c"), 1);
+  EXPECT_EQ(VectorKernels<std::string>::count(words, 4, "c"), 2);
+  EXPECT_EQ(VectorKernels<std::string>::min(words, 4), "a");
+  EXPECT_EQ(VectorKernels<std::string>::sum(words, 4), "bcac");
+  VectorKernels<std::string>::reverse(words, 4);
+  EXPECT_EQ(words[0], "c");
+  EXPECT_EQ(words[3], "b");
+}